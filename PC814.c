@@ -13,6 +13,7 @@
 
 #include "PC814.h"
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 
 /* Default values */
@@ -20,6 +21,10 @@
 #define PC814_DEFAULT_TOLERANCE 5.0f    /* Default frequency tolerance (%) */
 #define PC814_PERIOD_50HZ_US 10000      /* Period for 50Hz in microseconds */
 #define PC814_PERIOD_60HZ_US 8333       /* Period for 60Hz in microseconds */
+#define PC814_DEFAULT_LOSS_CYCLES 1     /* Missing cycles before loss of signal */
+#define PC814_AUTORANGE_LOCK_CYCLES 3   /* Consistent periods to lock */
+#define PC814_AUTORANGE_UNLOCK_CYCLES 8 /* Invalid periods to drop lock */
+#define PC814_AUTORANGE_TRACK_SHIFT 3   /* Drift tracking time constant (1/8) */
 
 /* Validate frequency */
 static bool validate_frequency(uint32_t freq, uint32_t expected, float tolerance)
@@ -34,16 +39,221 @@ static bool validate_frequency(uint32_t freq, uint32_t expected, float tolerance
     return percent <= tolerance;
 }
 
-/* Initialize PC814 handle */
-pc814_status_t pc814_init(pc814_handle_t *handle, pc814_port_t *port, 
-                          pc814_pull_t pull_config, pc814_edge_t edge_type)
+#ifdef PC814_PORT_STATIC_HEADER
+#include "PC814_PortStatic.h"
+
+/* Port dispatch: functions bound at compile time, called directly (inlinable) */
+#define PORT_BOUND                 1
+#define PORT_READY(h)              ((void)(h), 1)
+#define PORT_HAS(h, fn)            ((void)(h), PC814_PORT_HAS_##fn)
+#define PORT_CALL(h, fn)           pc814_port_##fn((h)->port_ctx)
+#define PORT_CALL_ARG(h, fn, arg)  pc814_port_##fn((h)->port_ctx, (arg))
+#else
+/* Port dispatch: v2 functions receive the handle's context, v1 functions none */
+#define PORT_BOUND                 0
+#define PORT_READY(h)              ((h)->port != NULL || (h)->port_v2 != NULL)
+#define PORT_HAS(h, fn)            (((h)->port_v2 != NULL) ? ((h)->port_v2->fn != NULL) : ((h)->port->fn != NULL))
+#define PORT_CALL(h, fn)           (((h)->port_v2 != NULL) ? (h)->port_v2->fn((h)->port_ctx) : (h)->port->fn())
+#define PORT_CALL_ARG(h, fn, arg)  (((h)->port_v2 != NULL) ? (h)->port_v2->fn((h)->port_ctx, (arg)) : (h)->port->fn(arg))
+#endif
+
+/* Convert timer ticks to microseconds (64-bit intermediate avoids overflow) */
+static uint32_t ticks_to_us(uint32_t ticks, uint32_t timer_freq)
 {
-    if (handle == NULL || port == NULL) {
-        return PC814_ERROR;
+    return (uint32_t)(((uint64_t)ticks * 1000000ULL) / timer_freq);
+}
+
+/* Convert microseconds to timer ticks */
+static uint32_t us_to_ticks(uint32_t us, uint32_t timer_freq)
+{
+    return (uint32_t)(((uint64_t)us * timer_freq) / 1000000ULL);
+}
+
+/* Bus event for each line event */
+static const uint8_t event_to_bus[] = {
+    PC814_BUS_MISSING_CYCLE,    /* PC814_EVENT_MISSING_CYCLE */
+    PC814_BUS_LOSS,             /* PC814_EVENT_LOSS_OF_SIGNAL */
+    PC814_BUS_RELOCK,           /* PC814_EVENT_SIGNAL_RESTORED */
+    PC814_BUS_RELOCK,           /* PC814_EVENT_FREQUENCY_LOCK */
+    PC814_BUS_LOSS              /* PC814_EVENT_FREQUENCY_UNLOCK */
+};
+
+/* Report line event */
+static void emit_event(pc814_handle_t *handle, pc814_event_t event)
+{
+    if (handle->event_callback != NULL) {
+        handle->event_callback(handle, event);
+    }
+    if (handle->bus != NULL) {
+        pc814_bus_publish(handle, (pc814_bus_event_t)event_to_bus[event]);
+    }
+}
+
+/* Report zero-crossing in handle->data */
+static void emit_crossing(pc814_handle_t *handle)
+{
+    if (handle->callback != NULL) {
+        handle->callback(handle, &handle->data);
+    }
+    if (handle->bus != NULL) {
+        pc814_bus_publish(handle, PC814_BUS_VALID_ZC);
+    }
+}
+
+/* Arm watchdog compare at predicted next zero-crossing plus margin */
+static void watchdog_arm(pc814_handle_t *handle, uint32_t capture)
+{
+    if (!handle->watchdog_enabled || handle->last_period_ticks == 0 ||
+        !PORT_HAS(handle, timer_set_compare)) {
+        return;
     }
     
-    memset(handle, 0, sizeof(pc814_handle_t));
-    handle->port = port;
+    handle->watchdog_compare = capture + handle->last_period_ticks + handle->watchdog_margin_ticks;
+    PORT_CALL_ARG(handle, timer_set_compare, handle->watchdog_compare);
+}
+
+/* Number of whole cycles spanned by a measured period (1 if not a clean gap) */
+static uint32_t flywheel_gap_cycles(pc814_handle_t *handle, uint32_t period_ticks)
+{
+    uint32_t ref = handle->last_period_ticks;
+    if (ref == 0) {
+        return 1;
+    }
+    
+    uint32_t cycles = (period_ticks + ref / 2) / ref;
+    if (cycles < 2) {
+        return 1;
+    }
+    
+    /* Gap must be a whole number of cycles within the frequency tolerance */
+    uint32_t expected = cycles * ref;
+    uint32_t residual = (period_ticks > expected) ? (period_ticks - expected) : (expected - period_ticks);
+    uint32_t allowed = (uint32_t)((float)ref * handle->frequency_tolerance / 100.0f);
+    
+    return (residual <= allowed) ? cycles : 1;
+}
+
+/* Deliver one synthetic zero-crossing one period after the last one */
+static void flywheel_emit(pc814_handle_t *handle)
+{
+    handle->data.period_us = handle->last_period_us;
+    handle->data.period_ticks = handle->last_period_ticks;
+    handle->data.timestamp_us += handle->last_period_us;
+    handle->data.capture_ticks += handle->last_period_ticks;
+    handle->data.count++;
+    handle->data.valid = true;
+    handle->data.synthetic = true;
+    handle->statistics.synthetic_zc_count++;
+    handle->flywheel_pending++;
+    
+    emit_crossing(handle);
+}
+
+/* Disarm watchdog compare */
+static void watchdog_disarm(pc814_handle_t *handle)
+{
+    if (PORT_READY(handle) && PORT_HAS(handle, timer_disable_compare)) {
+        PORT_CALL(handle, timer_disable_compare);
+    }
+}
+
+/* Check if two periods agree within tolerance (%) */
+static bool periods_agree(uint32_t period_us, uint32_t reference_us, float tolerance)
+{
+    uint32_t diff = (period_us > reference_us) ? (period_us - reference_us) : (reference_us - period_us);
+    return ((float)diff * 100.0f) <= ((float)reference_us * tolerance);
+}
+
+/* Set expected frequency from tracked period (Q4 us), rounded to nearest Hz */
+static void autorange_set_expected(pc814_handle_t *handle)
+{
+    handle->expected_frequency = (16000000UL + handle->autorange_period_q4 / 2) /
+                                 handle->autorange_period_q4;
+}
+
+/* Auto-range acquisition and drift tracking, returns true while locked */
+static bool autorange_update(pc814_handle_t *handle, uint32_t period_us, uint32_t freq_hz)
+{
+    if (!handle->autorange_locked) {
+        bool in_range = (freq_hz >= handle->autorange_min_hz && freq_hz <= handle->autorange_max_hz);
+        uint32_t candidate_us = handle->autorange_period_q4 >> 4;
+        
+        if (!in_range) {
+            handle->autorange_agree = 0;
+            return false;
+        }
+        
+        if (handle->autorange_agree > 0 &&
+            periods_agree(period_us, candidate_us, handle->frequency_tolerance)) {
+            /* Average candidate over the consistent periods */
+            handle->autorange_agree++;
+            handle->autorange_period_q4 += (int32_t)((period_us << 4) - handle->autorange_period_q4) /
+                                           (int32_t)handle->autorange_agree;
+        } else {
+            handle->autorange_agree = 1;
+            handle->autorange_period_q4 = period_us << 4;
+        }
+        
+        uint32_t lock_cycles = handle->fast_acquire ? 1 : PC814_AUTORANGE_LOCK_CYCLES;
+        if (handle->autorange_agree >= lock_cycles) {
+            handle->autorange_locked = true;
+            handle->autorange_misses = 0;
+            autorange_set_expected(handle);
+            emit_event(handle, PC814_EVENT_FREQUENCY_LOCK);
+        }
+        return handle->autorange_locked;
+    }
+    
+    if (validate_frequency(freq_hz, handle->expected_frequency, handle->frequency_tolerance)) {
+        /* Follow drift so validation bounds move with the source */
+        int32_t error = (int32_t)(period_us << 4) - (int32_t)handle->autorange_period_q4;
+        handle->autorange_period_q4 += error >> PC814_AUTORANGE_TRACK_SHIFT;
+        autorange_set_expected(handle);
+        handle->autorange_misses = 0;
+    } else if (++handle->autorange_misses >= PC814_AUTORANGE_UNLOCK_CYCLES) {
+        handle->autorange_locked = false;
+        handle->autorange_agree = 0;
+        emit_event(handle, PC814_EVENT_FREQUENCY_UNLOCK);
+        return false;
+    }
+    
+    return true;
+}
+
+/* Checksum of warm-start state */
+static uint32_t warm_state_checksum(const pc814_warm_state_t *state)
+{
+    uint32_t sum = state->magic;
+    sum = (sum << 5) ^ (sum >> 27) ^ state->timer_frequency;
+    sum = (sum << 5) ^ (sum >> 27) ^ state->period_ticks;
+    sum = (sum << 5) ^ (sum >> 27) ^ state->period_us;
+    sum = (sum << 5) ^ (sum >> 27) ^ state->expected_frequency;
+    return ~sum;
+}
+
+/* Check first measured period against warm state, fall back to cold acquisition */
+static void warm_confirm(pc814_handle_t *handle, uint32_t period_us)
+{
+    handle->warm_pending = false;
+    if (periods_agree(period_us, handle->last_period_us, handle->frequency_tolerance)) {
+        return;
+    }
+    
+    /* Restored period is stale: drop it and acquire as after a cold start */
+    handle->warm_started = false;
+    handle->lock_info.warm_started = false;
+    handle->last_period_ticks = 0;
+    handle->last_period_us = 0;
+    handle->kalman.state = PC814_KALMAN_EMPTY;
+    if (handle->autorange_enabled) {
+        handle->autorange_locked = false;
+        handle->autorange_agree = 0;
+    }
+}
+
+/* Common handle setup once the port is bound */
+static void init_handle(pc814_handle_t *handle, pc814_pull_t pull_config, pc814_edge_t edge_type)
+{
     handle->pull_config = pull_config;
     handle->edge_type = edge_type;
     handle->expected_frequency = PC814_DEFAULT_FREQ;
@@ -53,37 +263,204 @@ pc814_status_t pc814_init(pc814_handle_t *handle, pc814_port_t *port,
     handle->callback = NULL;
     handle->period_sum = 0;
     handle->period_count = 0;
+    handle->watchdog_loss_cycles = PC814_DEFAULT_LOSS_CYCLES;
     memset(&handle->statistics, 0, sizeof(pc814_statistics_t));
     
     /* Configure GPIO pull-up/pull-down */
     if (pull_config == PC814_PULL_UP) {
-        if (port->gpio_set_pull_up != NULL) {
-            port->gpio_set_pull_up();
+        if (PORT_HAS(handle, gpio_set_pull_up)) {
+            PORT_CALL(handle, gpio_set_pull_up);
         }
     } else {
-        if (port->gpio_set_pull_down != NULL) {
-            port->gpio_set_pull_down();
+        if (PORT_HAS(handle, gpio_set_pull_down)) {
+            PORT_CALL(handle, gpio_set_pull_down);
         }
     }
     
     handle->initialized = true;
+}
+
+/* Initialize PC814 handle */
+pc814_status_t pc814_init(pc814_handle_t *handle, pc814_port_t *port, 
+                          pc814_pull_t pull_config, pc814_edge_t edge_type)
+{
+    if (handle == NULL || (port == NULL && !PORT_BOUND)) {
+        return PC814_ERROR;
+    }
+    
+    memset(handle, 0, sizeof(pc814_handle_t));
+    handle->port = port;
+    init_handle(handle, pull_config, edge_type);
+    
+    return PC814_OK;
+}
+
+/* Initialize PC814 handle with context port */
+pc814_status_t pc814_init_v2(pc814_handle_t *handle, const pc814_port_v2_t *port, void *ctx,
+                             pc814_pull_t pull_config, pc814_edge_t edge_type)
+{
+    if (handle == NULL || (port == NULL && !PORT_BOUND)) {
+        return PC814_ERROR;
+    }
+    
+    memset(handle, 0, sizeof(pc814_handle_t));
+    handle->port_v2 = port;
+    handle->port_ctx = ctx;
+    init_handle(handle, pull_config, edge_type);
+    
+    return PC814_OK;
+}
+
+/* Get port context */
+void *pc814_get_port_context(pc814_handle_t *handle)
+{
+    if (handle == NULL) {
+        return NULL;
+    }
+    return handle->port_ctx;
+}
+
+/* Read port time */
+pc814_status_t pc814_get_port_time_us(pc814_handle_t *handle, uint32_t *time_us)
+{
+    if (handle == NULL || time_us == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+    if (!PORT_HAS(handle, get_time_us)) {
+        return PC814_ERROR;
+    }
+    
+    *time_us = PORT_CALL(handle, get_time_us);
     return PC814_OK;
 }
 
 /* Process Timer Input Capture */
 pc814_status_t pc814_process_capture(pc814_handle_t *handle)
 {
-    if (handle == NULL || !handle->initialized || handle->port == NULL) {
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
         return PC814_NOT_INITIALIZED;
     }
     
-    if (handle->port->timer_get_capture_value == NULL ||
-        handle->port->timer_get_frequency == NULL) {
+    if (!PORT_HAS(handle, timer_get_capture_value)) {
         return PC814_ERROR;
     }
     
-    uint32_t current_capture = handle->port->timer_get_capture_value();
-    uint32_t timer_freq = handle->port->timer_get_frequency();
+    return pc814_process_capture_value(handle, PORT_CALL(handle, timer_get_capture_value));
+}
+
+#ifdef PC814_INSTRUMENTATION
+/* Add one sample to a min/max/sum timing series */
+static void timing_sample(uint32_t value, uint32_t *samples, uint32_t *last,
+                          uint32_t *min, uint32_t *max, uint64_t *sum)
+{
+    if (*samples == 0 || value < *min) {
+        *min = value;
+    }
+    if (value > *max) {
+        *max = value;
+    }
+    *last = value;
+    *sum += value;
+    (*samples)++;
+}
+#endif
+
+/* Record a measured period: data, statistics and reports */
+static void record_period(pc814_handle_t *handle, uint32_t capture, uint32_t now,
+                          uint32_t period_ticks, uint32_t period_us, uint32_t freq_hz, bool valid)
+{
+    /* Update data */
+    handle->data.period_us = period_us;
+    handle->data.period_ticks = period_ticks;
+    handle->data.capture_ticks = capture;
+    handle->data.frequency_hz = freq_hz;
+    handle->data.timestamp_us = now;
+    handle->data.count++;
+    handle->data.valid = valid;
+    handle->data.synthetic = false;
+    
+    /* Update statistics */
+    if (valid) {
+        handle->last_period_ticks = period_ticks;
+        handle->last_period_us = period_us;
+        handle->statistics.total_zc_count++;
+        handle->statistics.valid_zc_count++;
+        
+        /* Update min/max period */
+        if (handle->statistics.min_period_us == 0 || period_us < handle->statistics.min_period_us) {
+            handle->statistics.min_period_us = period_us;
+        }
+        if (period_us > handle->statistics.max_period_us) {
+            handle->statistics.max_period_us = period_us;
+        }
+        
+        /* Update min/max frequency */
+        float freq_float = (float)freq_hz;
+        if (handle->statistics.min_frequency_hz == 0.0f || freq_float < handle->statistics.min_frequency_hz) {
+            handle->statistics.min_frequency_hz = freq_float;
+        }
+        if (freq_float > handle->statistics.max_frequency_hz) {
+            handle->statistics.max_frequency_hz = freq_float;
+        }
+        
+        /* Update average period */
+        handle->period_sum += period_us;
+        handle->period_count++;
+        if (handle->period_count > 0) {
+            handle->statistics.avg_period_us = handle->period_sum / handle->period_count;
+            handle->statistics.avg_frequency_hz = 1000000.0f / (float)handle->statistics.avg_period_us;
+        }
+    } else {
+        handle->statistics.total_zc_count++;
+        handle->statistics.invalid_zc_count++;
+    }
+    
+    /* Report crossing; a rejected edge faster than expected is a glitch */
+    if (valid) {
+        emit_crossing(handle);
+    } else if (handle->bus != NULL) {
+        pc814_bus_publish(handle, (freq_hz > handle->expected_frequency) ?
+                          PC814_BUS_GLITCH : PC814_BUS_INVALID_ZC);
+    }
+}
+
+/* Finish an edge: time-to-lock, watchdog and capture hook */
+static void finish_edge(pc814_handle_t *handle, uint32_t capture, uint32_t now)
+{
+    /* Time-to-lock: first valid zero-crossing since start */
+    if (!handle->lock_info.locked && handle->data.valid) {
+        handle->lock_info.locked = true;
+        handle->lock_info.time_to_lock_us = now - handle->start_time_us;
+    }
+    
+    handle->last_capture_value = capture;
+    handle->last_capture_time = now;
+    
+    /* Edge arrived: clear missing-cycle run and report restore after loss */
+    handle->watchdog.consecutive_missing = 0;
+    if (handle->watchdog.signal_lost) {
+        handle->watchdog.signal_lost = false;
+        handle->watchdog.restore_count++;
+        handle->watchdog.last_restore_time_us = now;
+        emit_event(handle, PC814_EVENT_SIGNAL_RESTORED);
+    }
+    
+    watchdog_arm(handle, capture);
+    
+    if (handle->capture_hook != NULL) {
+        handle->capture_hook(handle->capture_hook_context, handle);
+    }
+}
+
+/* Capture processing (timed by pc814_process_capture_value) */
+static pc814_status_t process_capture_value(pc814_handle_t *handle, uint32_t current_capture)
+{
+    if (!PORT_HAS(handle, timer_get_frequency)) {
+        return PC814_ERROR;
+    }
+    
+    uint32_t timer_freq = PORT_CALL(handle, timer_get_frequency);
     
     if (current_capture == 0 || timer_freq == 0) {
         return PC814_ERROR;
@@ -91,84 +468,222 @@ pc814_status_t pc814_process_capture(pc814_handle_t *handle)
     
     /* Get current time */
     uint32_t current_time = 0;
-    if (handle->port->get_time_us != NULL) {
-        current_time = handle->port->get_time_us();
+    if (PORT_HAS(handle, get_time_us)) {
+        current_time = PORT_CALL(handle, get_time_us);
+    }
+    
+    if (!handle->lock_info.locked) {
+        handle->lock_info.edges_to_lock++;
     }
     
+    bool seeded = false;
+    
     /* Calculate period if we have previous capture */
     if (handle->last_capture_value != 0) {
-        uint32_t period_ticks;
+        /* Unsigned subtraction handles timer overflow */
+        uint32_t period_ticks = current_capture - handle->last_capture_value;
         
-        if (current_capture > handle->last_capture_value) {
-            period_ticks = current_capture - handle->last_capture_value;
-        } else {
-            /* Handle timer overflow */
-            period_ticks = (0xFFFFFFFF - handle->last_capture_value) + current_capture;
+        /* Flywheel: split a gap of whole missing cycles into single cycles */
+        if (handle->flywheel_enabled) {
+            uint32_t cycles = flywheel_gap_cycles(handle, period_ticks);
+            uint32_t missing = cycles - 1;
+            
+            /* After loss of signal only a gap the flywheel could have bridged is split */
+            if (cycles > 1 &&
+                (!handle->watchdog.signal_lost || missing <= handle->flywheel_max_cycles)) {
+                /* Synthesize what the compare interrupt has not already delivered */
+                while (handle->flywheel_pending < missing &&
+                       handle->flywheel_pending < handle->flywheel_max_cycles) {
+                    flywheel_emit(handle);
+                }
+                
+                /* Beyond the flywheel limit only the count is advanced */
+                if (missing > handle->flywheel_pending) {
+                    handle->data.count += missing - handle->flywheel_pending;
+                }
+                
+                period_ticks /= cycles;
+            }
         }
+        handle->flywheel_pending = 0;
         
         /* Convert ticks to microseconds */
-        uint32_t period_us = (period_ticks * 1000000UL) / timer_freq;
+        uint32_t period_us = ticks_to_us(period_ticks, timer_freq);
+        if (period_us == 0) {
+            return PC814_ERROR;
+        }
+        
+        /* Warm start: lock only if the first measured period confirms the state */
+        if (handle->warm_pending) {
+            warm_confirm(handle, period_us);
+        }
         
         /* Calculate frequency */
         uint32_t freq_hz = 1000000UL / period_us;
         
-        /* Validate frequency */
-        bool freq_valid = validate_frequency(freq_hz, handle->expected_frequency, 
+        /* Validate frequency (no valid data while auto-range is acquiring) */
+        bool freq_valid = false;
+        if (!handle->autorange_enabled || autorange_update(handle, period_us, freq_hz)) {
+            freq_valid = validate_frequency(freq_hz, handle->expected_frequency, 
                                             handle->frequency_tolerance);
-        
-        /* Update data */
-        handle->data.period_us = period_us;
-        handle->data.frequency_hz = freq_hz;
-        handle->data.timestamp_us = current_time;
-        handle->data.count++;
-        handle->data.valid = freq_valid;
-        
-        /* Update statistics */
-        if (freq_valid) {
-            handle->statistics.total_zc_count++;
-            handle->statistics.valid_zc_count++;
-            
-            /* Update min/max period */
-            if (handle->statistics.min_period_us == 0 || period_us < handle->statistics.min_period_us) {
-                handle->statistics.min_period_us = period_us;
-            }
-            if (period_us > handle->statistics.max_period_us) {
-                handle->statistics.max_period_us = period_us;
-            }
-            
-            /* Update min/max frequency */
-            float freq_float = (float)freq_hz;
-            if (handle->statistics.min_frequency_hz == 0.0f || freq_float < handle->statistics.min_frequency_hz) {
-                handle->statistics.min_frequency_hz = freq_float;
-            }
-            if (freq_float > handle->statistics.max_frequency_hz) {
-                handle->statistics.max_frequency_hz = freq_float;
-            }
-            
-            /* Update average period */
-            handle->period_sum += period_us;
-            handle->period_count++;
-            if (handle->period_count > 0) {
-                handle->statistics.avg_period_us = handle->period_sum / handle->period_count;
-                handle->statistics.avg_frequency_hz = 1000000.0f / (float)handle->statistics.avg_period_us;
-            }
-        } else {
-            handle->statistics.total_zc_count++;
-            handle->statistics.invalid_zc_count++;
         }
         
-        /* Call callback if set */
-        if (handle->callback != NULL && freq_valid) {
-            handle->callback(handle, &handle->data);
-        }
+        record_period(handle, current_capture, current_time, period_ticks, period_us,
+                      freq_hz, freq_valid);
+    } else if (handle->warm_pending && handle->kalman_enabled) {
+        /* Phase from this edge, period from warm state until confirmed */
+        pc814_kalman_seed(&handle->kalman, current_capture, handle->last_period_ticks);
+        seeded = true;
+    }
+    
+    /* Kalman tracker runs on raw edges, it bridges gaps on its own */
+    if (handle->kalman_enabled && !seeded) {
+        pc814_kalman_update(&handle->kalman, current_capture);
     }
     
-    handle->last_capture_value = current_capture;
-    handle->last_capture_time = current_time;
+    finish_edge(handle, current_capture, current_time);
     
     return PC814_OK;
 }
 
+/* Process capture value supplied by the caller */
+pc814_status_t pc814_process_capture_value(pc814_handle_t *handle, uint32_t current_capture)
+{
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+#ifdef PC814_INSTRUMENTATION
+    pc814_timing_t *timing = &handle->timing;
+    uint32_t start = PORT_HAS(handle, get_cycles) ? PORT_CALL(handle, get_cycles) : 0;
+    
+    /* Latency: counter now minus the tick the edge was captured at */
+    if (PORT_HAS(handle, timer_get_counter) && current_capture != 0) {
+        timing_sample(PORT_CALL(handle, timer_get_counter) - current_capture,
+                      &timing->latency_samples, &timing->last_latency_ticks,
+                      &timing->min_latency_ticks, &timing->max_latency_ticks, &timing->latency_sum);
+    }
+    
+    pc814_status_t status = process_capture_value(handle, current_capture);
+    
+    if (PORT_HAS(handle, get_cycles)) {
+        timing_sample(PORT_CALL(handle, get_cycles) - start,
+                      &timing->cycle_samples, &timing->last_cycles,
+                      &timing->min_cycles, &timing->max_cycles, &timing->cycle_sum);
+    }
+    
+    return status;
+#else
+    return process_capture_value(handle, current_capture);
+#endif
+}
+
+/* Record an edge measured and validated by the caller */
+void pc814_record_capture(pc814_handle_t *handle, uint32_t capture, uint32_t now,
+                          uint32_t period_ticks, uint32_t period_us, bool valid)
+{
+    if (handle == NULL || !handle->initialized) {
+        return;
+    }
+    
+    if (!handle->lock_info.locked) {
+        handle->lock_info.edges_to_lock++;
+    }
+    
+    if (period_ticks != 0) {
+        uint32_t freq_hz = (period_us != 0) ? (1000000UL / period_us) : 0;
+        record_period(handle, capture, now, period_ticks, period_us, freq_hz, valid && freq_hz != 0);
+    }
+    
+    finish_edge(handle, capture, now);
+}
+
+/* Process timer compare match (missing zero-crossing) */
+pc814_status_t pc814_process_compare(pc814_handle_t *handle)
+{
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+    if (!handle->watchdog_enabled || handle->watchdog.signal_lost) {
+        return PC814_ERROR;
+    }
+    
+    uint32_t current_time = 0;
+    if (PORT_HAS(handle, get_time_us)) {
+        current_time = PORT_CALL(handle, get_time_us);
+    }
+    
+    handle->watchdog.missing_cycle_count++;
+    handle->watchdog.consecutive_missing++;
+    handle->watchdog.last_missing_time_us = current_time;
+    emit_event(handle, PC814_EVENT_MISSING_CYCLE);
+    
+    /* Flywheel keeps zero-crossings running through short dropouts */
+    if (handle->flywheel_enabled && handle->last_period_us != 0 &&
+        handle->watchdog.consecutive_missing <= handle->flywheel_max_cycles) {
+        flywheel_emit(handle);
+    } else {
+        handle->data.valid = false;
+    }
+    
+    if (handle->watchdog.consecutive_missing >= handle->watchdog_loss_cycles) {
+        /* Loss of signal: stop re-arming until the next capture */
+        handle->watchdog.signal_lost = true;
+        handle->watchdog.loss_count++;
+        handle->watchdog.last_loss_time_us = current_time;
+        watchdog_disarm(handle);
+        emit_event(handle, PC814_EVENT_LOSS_OF_SIGNAL);
+        return PC814_OK;
+    }
+    
+    /* Re-arm one period later to catch the next missing cycle */
+    handle->watchdog_compare += handle->last_period_ticks;
+    if (PORT_HAS(handle, timer_set_compare)) {
+        PORT_CALL_ARG(handle, timer_set_compare, handle->watchdog_compare);
+    }
+    
+    return PC814_OK;
+}
+
+/* Initialize extended timebase */
+pc814_status_t pc814_timebase_init(pc814_timebase_t *timebase, uint8_t counter_bits)
+{
+    if (timebase == NULL || counter_bits == 0 || counter_bits > 32) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    timebase->high = 0;
+    timebase->counter_bits = counter_bits;
+    return PC814_OK;
+}
+
+/* Register counter overflow */
+void pc814_timebase_overflow(pc814_timebase_t *timebase)
+{
+    if (timebase != NULL && timebase->counter_bits < 32) {
+        timebase->high += (1UL << timebase->counter_bits);
+    }
+}
+
+/* Extend raw capture to 32 bits */
+uint32_t pc814_timebase_extend(const pc814_timebase_t *timebase, uint32_t raw_capture,
+                               bool overflow_pending)
+{
+    if (timebase == NULL || timebase->counter_bits >= 32) {
+        return raw_capture;
+    }
+    
+    uint32_t value = timebase->high + raw_capture;
+    
+    /* Capture taken after an overflow whose interrupt has not run yet */
+    if (overflow_pending && raw_capture < (1UL << (timebase->counter_bits - 1))) {
+        value += (1UL << timebase->counter_bits);
+    }
+    
+    return value;
+}
+
 /* Read zero-crossing data */
 pc814_status_t pc814_read_data(pc814_handle_t *handle, pc814_data_t *data)
 {
@@ -210,15 +725,15 @@ uint32_t pc814_get_count(pc814_handle_t *handle)
 /* Get time since last zero-crossing */
 uint32_t pc814_get_time_since_zc(pc814_handle_t *handle)
 {
-    if (handle == NULL || !handle->initialized || handle->port == NULL) {
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
         return 0;
     }
     
-    if (handle->port->get_time_us == NULL) {
+    if (!PORT_HAS(handle, get_time_us)) {
         return 0;
     }
     
-    uint32_t current_time = handle->port->get_time_us();
+    uint32_t current_time = PORT_CALL(handle, get_time_us);
     if (current_time < handle->data.timestamp_us) {
         /* Handle time overflow */
         return 0;
@@ -228,11 +743,57 @@ uint32_t pc814_get_time_since_zc(pc814_handle_t *handle)
 }
 
 /* Set expected line frequency */
-void pc814_set_expected_frequency(pc814_handle_t *handle, uint32_t freq)
+pc814_status_t pc814_set_expected_frequency(pc814_handle_t *handle, uint32_t freq)
+{
+    if (handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    if (freq < PC814_FREQ_MIN_HZ || freq > PC814_FREQ_MAX_HZ) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    handle->expected_frequency = freq;
+    return PC814_OK;
+}
+
+/* Enable auto-range */
+pc814_status_t pc814_autorange_enable(pc814_handle_t *handle, uint32_t min_hz, uint32_t max_hz)
+{
+    if (handle == NULL || !handle->initialized) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+    if (min_hz < PC814_FREQ_MIN_HZ || max_hz > PC814_FREQ_MAX_HZ || min_hz >= max_hz) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    handle->autorange_min_hz = min_hz;
+    handle->autorange_max_hz = max_hz;
+    handle->autorange_locked = false;
+    handle->autorange_agree = 0;
+    handle->autorange_misses = 0;
+    handle->autorange_enabled = true;
+    
+    return PC814_OK;
+}
+
+/* Disable auto-range */
+void pc814_autorange_disable(pc814_handle_t *handle)
+{
+    if (handle != NULL) {
+        handle->autorange_enabled = false;
+        handle->autorange_locked = false;
+    }
+}
+
+/* Check auto-range lock */
+bool pc814_autorange_is_locked(pc814_handle_t *handle)
 {
-    if (handle != NULL && (freq == 50 || freq == 60)) {
-        handle->expected_frequency = freq;
+    if (handle == NULL || !handle->initialized) {
+        return false;
     }
+    return handle->autorange_enabled && handle->autorange_locked;
 }
 
 /* Set frequency tolerance */
@@ -263,9 +824,21 @@ void pc814_reset(pc814_handle_t *handle)
     handle->last_capture_time = 0;
     handle->data.count = 0;
     handle->data.valid = false;
+    handle->last_period_ticks = 0;
+    handle->last_period_us = 0;
+    handle->flywheel_pending = 0;
+    handle->data.synthetic = false;
+    handle->kalman.state = PC814_KALMAN_EMPTY;
+    handle->autorange_locked = false;
+    handle->autorange_agree = 0;
+    handle->warm_started = false;
+    handle->warm_pending = false;
+    handle->watchdog.consecutive_missing = 0;
+    handle->watchdog.signal_lost = false;
+    watchdog_disarm(handle);
     
-    if (handle->port != NULL && handle->port->timer_reset_capture != NULL) {
-        handle->port->timer_reset_capture();
+    if (PORT_READY(handle) && PORT_HAS(handle, timer_reset_capture)) {
+        PORT_CALL(handle, timer_reset_capture);
     }
 }
 
@@ -277,15 +850,405 @@ void pc814_set_callback(pc814_handle_t *handle, pc814_zc_callback_t callback)
     }
 }
 
+/* Set event callback */
+void pc814_set_event_callback(pc814_handle_t *handle, pc814_event_callback_t callback)
+{
+    if (handle != NULL) {
+        handle->event_callback = callback;
+    }
+}
+
+/* Set capture hook */
+void pc814_set_capture_hook(pc814_handle_t *handle, pc814_capture_hook_t hook, void *context)
+{
+    if (handle != NULL) {
+        handle->capture_hook = hook;
+        handle->capture_hook_context = context;
+    }
+}
+
+/* Set user context */
+void pc814_set_user_context(pc814_handle_t *handle, void *context)
+{
+    if (handle != NULL) {
+        handle->user_context = context;
+    }
+}
+
+/* Get user context */
+void *pc814_get_user_context(pc814_handle_t *handle)
+{
+    if (handle == NULL) {
+        return NULL;
+    }
+    return handle->user_context;
+}
+
+/* Rebuild per-event routes from the subscriptions */
+static void bus_compile(pc814_bus_t *bus)
+{
+    memset(bus->route_count, 0, sizeof(bus->route_count));
+    bus->listener_count = 0;
+    
+    for (uint8_t id = 0; id < PC814_BUS_MAX_LISTENERS; id++) {
+        pc814_subscription_t *sub = &bus->subscription[id];
+        if (sub->listener == NULL) {
+            continue;
+        }
+        
+        bus->listener_count++;
+        for (uint8_t event = 0; event < PC814_BUS_EVENT_COUNT; event++) {
+            if (sub->mask & PC814_BUS_MASK(event)) {
+                bus->route[event][bus->route_count[event]++] = id;
+            }
+        }
+    }
+}
+
+/* Initialize event bus */
+pc814_status_t pc814_bus_init(pc814_bus_t *bus)
+{
+    if (bus == NULL) {
+        return PC814_ERROR;
+    }
+    
+    memset(bus, 0, sizeof(pc814_bus_t));
+    bus->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Subscribe listener */
+pc814_status_t pc814_bus_subscribe(pc814_bus_t *bus, uint16_t mask, uint16_t decimation,
+                                   pc814_listener_t listener, void *context, uint8_t *id)
+{
+    if (bus == NULL || !bus->initialized || listener == NULL) {
+        return PC814_ERROR;
+    }
+    
+    if ((mask & PC814_BUS_MASK_ALL) == 0 || (mask & ~PC814_BUS_MASK_ALL) != 0 || decimation == 0) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    for (uint8_t slot = 0; slot < PC814_BUS_MAX_LISTENERS; slot++) {
+        pc814_subscription_t *sub = &bus->subscription[slot];
+        if (sub->listener != NULL) {
+            continue;
+        }
+        
+        sub->listener = listener;
+        sub->context = context;
+        sub->mask = mask;
+        sub->decimation = decimation;
+        sub->countdown = decimation;
+        bus_compile(bus);
+        
+        if (id != NULL) {
+            *id = slot;
+        }
+        return PC814_OK;
+    }
+    
+    return PC814_ERROR;
+}
+
+/* Remove subscription */
+pc814_status_t pc814_bus_unsubscribe(pc814_bus_t *bus, uint8_t id)
+{
+    if (bus == NULL || !bus->initialized) {
+        return PC814_ERROR;
+    }
+    
+    if (id >= PC814_BUS_MAX_LISTENERS || bus->subscription[id].listener == NULL) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    /* Drop the slot from every route before its listener is cleared */
+    bus->subscription[id].mask = 0;
+    bus_compile(bus);
+    memset(&bus->subscription[id], 0, sizeof(pc814_subscription_t));
+    
+    return PC814_OK;
+}
+
+/* Attach event bus */
+void pc814_set_bus(pc814_handle_t *handle, pc814_bus_t *bus)
+{
+    if (handle != NULL) {
+        handle->bus = bus;
+    }
+}
+
+/* Publish event to the handle's bus */
+void pc814_bus_publish(pc814_handle_t *handle, pc814_bus_event_t event)
+{
+    if (handle == NULL || handle->bus == NULL || (uint32_t)event >= PC814_BUS_EVENT_COUNT) {
+        return;
+    }
+    
+    pc814_bus_t *bus = handle->bus;
+    const uint8_t *route = bus->route[event];
+    uint8_t count = bus->route_count[event];
+    
+    /* Only the listeners of this event, in subscription order */
+    for (uint8_t i = 0; i < count; i++) {
+        pc814_subscription_t *sub = &bus->subscription[route[i]];
+        pc814_listener_t listener = sub->listener;
+        
+        if (listener == NULL || --sub->countdown != 0) {
+            continue;
+        }
+        sub->countdown = sub->decimation;
+        listener(sub->context, handle, event, &handle->data);
+    }
+}
+
+/* Enable cycle watchdog */
+pc814_status_t pc814_watchdog_enable(pc814_handle_t *handle, uint32_t margin_us,
+                                     uint32_t loss_cycles)
+{
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+    if (!PORT_HAS(handle, timer_set_compare) ||
+        !PORT_HAS(handle, timer_get_frequency)) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    if (loss_cycles == 0) {
+        loss_cycles = PC814_DEFAULT_LOSS_CYCLES;
+    }
+    
+    uint32_t timer_freq = PORT_CALL(handle, timer_get_frequency);
+    if (timer_freq == 0) {
+        return PC814_ERROR;
+    }
+    
+    handle->watchdog_margin_ticks = us_to_ticks(margin_us, timer_freq);
+    handle->watchdog_loss_cycles = loss_cycles;
+    handle->watchdog_enabled = true;
+    
+    return PC814_OK;
+}
+
+/* Disable cycle watchdog */
+void pc814_watchdog_disable(pc814_handle_t *handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    
+    handle->watchdog_enabled = false;
+    watchdog_disarm(handle);
+}
+
+/* Enable flywheel reconstruction */
+pc814_status_t pc814_flywheel_enable(pc814_handle_t *handle, uint32_t max_cycles)
+{
+    if (handle == NULL || !handle->initialized) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+    if (max_cycles == 0) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    handle->flywheel_max_cycles = max_cycles;
+    handle->flywheel_pending = 0;
+    handle->flywheel_enabled = true;
+    
+    return PC814_OK;
+}
+
+/* Disable flywheel reconstruction */
+void pc814_flywheel_disable(pc814_handle_t *handle)
+{
+    if (handle != NULL) {
+        handle->flywheel_enabled = false;
+        handle->flywheel_pending = 0;
+    }
+}
+
+/* Enable Kalman tracker */
+pc814_status_t pc814_kalman_enable(pc814_handle_t *handle, uint32_t process_noise_us,
+                                   uint32_t measurement_noise_us)
+{
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_NOT_INITIALIZED;
+    }
+    
+    if (!PORT_HAS(handle, timer_get_frequency)) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    uint32_t timer_freq = PORT_CALL(handle, timer_get_frequency);
+    if (timer_freq == 0) {
+        return PC814_ERROR;
+    }
+    
+    pc814_kalman_init(&handle->kalman, us_to_ticks(process_noise_us, timer_freq),
+                      us_to_ticks(measurement_noise_us, timer_freq));
+    handle->kalman_enabled = true;
+    
+    return PC814_OK;
+}
+
+/* Disable Kalman tracker */
+void pc814_kalman_disable(pc814_handle_t *handle)
+{
+    if (handle != NULL) {
+        handle->kalman_enabled = false;
+    }
+}
+
+/* Get Kalman tracker output */
+pc814_status_t pc814_get_kalman_output(pc814_handle_t *handle, pc814_kalman_output_t *output)
+{
+    if (handle == NULL || output == NULL || !handle->initialized || !handle->kalman_enabled ||
+        !PORT_READY(handle) || !PORT_HAS(handle, timer_get_frequency)) {
+        return PC814_ERROR;
+    }
+    
+    uint32_t timer_freq = PORT_CALL(handle, timer_get_frequency);
+    if (timer_freq == 0) {
+        return PC814_ERROR;
+    }
+    
+    const pc814_kalman_t *kf = &handle->kalman;
+    int32_t innovation = kf->innovation;
+    uint32_t innovation_abs = (innovation < 0) ? (uint32_t)(-innovation) : (uint32_t)innovation;
+    
+    memset(output, 0, sizeof(pc814_kalman_output_t));
+    output->valid = (kf->state == PC814_KALMAN_TRACKING);
+    output->frequency_mhz = pc814_kalman_get_frequency_mhz(kf, timer_freq);
+    output->period_ticks = pc814_kalman_get_period_ticks(kf);
+    output->period_us = ticks_to_us(output->period_ticks, timer_freq);
+    output->next_zc_ticks = pc814_kalman_predict(kf, 1);
+    output->innovation_abs_us = ticks_to_us(innovation_abs, timer_freq);
+    output->innovation_us = (innovation < 0) ? -(int32_t)output->innovation_abs_us
+                                             : (int32_t)output->innovation_abs_us;
+    output->rejected_count = kf->rejected_count;
+    
+    return PC814_OK;
+}
+
+/* Save warm-start state */
+pc814_status_t pc814_save_warm_state(pc814_handle_t *handle, pc814_warm_state_t *state)
+{
+    if (handle == NULL || state == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_ERROR;
+    }
+    
+    if (handle->last_period_ticks == 0 || !PORT_HAS(handle, timer_get_frequency)) {
+        return PC814_ERROR;
+    }
+    
+    memset(state, 0, sizeof(pc814_warm_state_t));
+    state->magic = PC814_WARM_STATE_MAGIC;
+    state->timer_frequency = PORT_CALL(handle, timer_get_frequency);
+    state->period_ticks = handle->last_period_ticks;
+    state->period_us = handle->last_period_us;
+    state->expected_frequency = handle->expected_frequency;
+    
+    /* Prefer the filtered period when the Kalman tracker is locked */
+    uint32_t kalman_period = pc814_kalman_get_period_ticks(&handle->kalman);
+    if (handle->kalman_enabled && kalman_period != 0) {
+        state->period_ticks = kalman_period;
+        state->period_us = ticks_to_us(kalman_period, state->timer_frequency);
+    }
+    
+    state->checksum = warm_state_checksum(state);
+    return PC814_OK;
+}
+
+/* Restore warm-start state */
+pc814_status_t pc814_warm_start(pc814_handle_t *handle, const pc814_warm_state_t *state)
+{
+    if (handle == NULL || state == NULL || !handle->initialized || !PORT_READY(handle)) {
+        return PC814_ERROR;
+    }
+    
+    if (state->magic != PC814_WARM_STATE_MAGIC ||
+        state->checksum != warm_state_checksum(state) ||
+        state->period_ticks == 0 || state->period_us == 0 ||
+        !PORT_HAS(handle, timer_get_frequency) ||
+        state->timer_frequency != PORT_CALL(handle, timer_get_frequency) ||
+        state->expected_frequency < PC814_FREQ_MIN_HZ ||
+        state->expected_frequency > PC814_FREQ_MAX_HZ) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    handle->last_period_ticks = state->period_ticks;
+    handle->last_period_us = state->period_us;
+    handle->expected_frequency = state->expected_frequency;
+    
+    /* Auto-range starts locked onto the restored period */
+    if (handle->autorange_enabled) {
+        handle->autorange_period_q4 = state->period_us << 4;
+        handle->autorange_locked = true;
+        handle->autorange_misses = 0;
+    }
+    
+    handle->warm_started = true;
+    handle->warm_pending = true;
+    return PC814_OK;
+}
+
+/* Enable/disable fast acquisition */
+void pc814_set_fast_acquire(pc814_handle_t *handle, bool enable)
+{
+    if (handle != NULL) {
+        handle->fast_acquire = enable;
+    }
+}
+
+/* Get lock acquisition metrics */
+pc814_status_t pc814_get_lock_info(pc814_handle_t *handle, pc814_lock_info_t *info)
+{
+    if (handle == NULL || info == NULL || !handle->initialized) {
+        return PC814_ERROR;
+    }
+    
+    memcpy(info, &handle->lock_info, sizeof(pc814_lock_info_t));
+    return PC814_OK;
+}
+
+/* Get cycle watchdog status */
+pc814_status_t pc814_get_watchdog_status(pc814_handle_t *handle, pc814_watchdog_status_t *status)
+{
+    if (handle == NULL || status == NULL || !handle->initialized) {
+        return PC814_ERROR;
+    }
+    
+    memcpy(status, &handle->watchdog, sizeof(pc814_watchdog_status_t));
+    return PC814_OK;
+}
+
+/* Check if signal is lost */
+bool pc814_is_signal_lost(pc814_handle_t *handle)
+{
+    if (handle == NULL || !handle->initialized) {
+        return false;
+    }
+    return handle->watchdog.signal_lost;
+}
+
 /* Start zero-crossing detection */
 pc814_status_t pc814_start(pc814_handle_t *handle)
 {
-    if (handle == NULL || !handle->initialized || handle->port == NULL) {
+    if (handle == NULL || !handle->initialized || !PORT_READY(handle)) {
         return PC814_ERROR;
     }
     
-    if (handle->port->timer_start_capture != NULL) {
-        handle->port->timer_start_capture();
+    memset(&handle->lock_info, 0, sizeof(pc814_lock_info_t));
+    handle->lock_info.warm_started = handle->warm_started;
+    if (PORT_HAS(handle, get_time_us)) {
+        handle->start_time_us = PORT_CALL(handle, get_time_us);
+    }
+    
+    if (PORT_HAS(handle, timer_start_capture)) {
+        PORT_CALL(handle, timer_start_capture);
     }
     
     return PC814_OK;
@@ -294,13 +1257,15 @@ pc814_status_t pc814_start(pc814_handle_t *handle)
 /* Stop zero-crossing detection */
 void pc814_stop(pc814_handle_t *handle)
 {
-    if (handle == NULL || handle->port == NULL) {
+    if (handle == NULL || !PORT_READY(handle)) {
         return;
     }
     
-    if (handle->port->timer_stop_capture != NULL) {
-        handle->port->timer_stop_capture();
+    if (PORT_HAS(handle, timer_stop_capture)) {
+        PORT_CALL(handle, timer_stop_capture);
     }
+    
+    watchdog_disarm(handle);
 }
 
 /* Calculate phase angle from time offset */
@@ -378,6 +1343,47 @@ void pc814_reset_statistics(pc814_handle_t *handle)
     handle->period_count = 0;
 }
 
+/* Get capture path timing */
+pc814_status_t pc814_get_timing(pc814_handle_t *handle, pc814_timing_t *timing)
+{
+#ifdef PC814_INSTRUMENTATION
+    if (handle == NULL || timing == NULL || !handle->initialized) {
+        return PC814_ERROR;
+    }
+    
+    memcpy(timing, &handle->timing, sizeof(pc814_timing_t));
+    
+    if (timing->cycle_samples > 0) {
+        timing->mean_cycles = (uint32_t)(timing->cycle_sum / timing->cycle_samples);
+    }
+    if (timing->latency_samples > 0) {
+        timing->mean_latency_ticks = (uint32_t)(timing->latency_sum / timing->latency_samples);
+        
+        uint32_t timer_freq = 0;
+        if (PORT_READY(handle) && PORT_HAS(handle, timer_get_frequency)) {
+            timer_freq = PORT_CALL(handle, timer_get_frequency);
+        }
+        if (timer_freq != 0) {
+            timing->max_latency_us = ticks_to_us(timing->max_latency_ticks, timer_freq);
+        }
+    }
+    
+    return PC814_OK;
+#else
+    (void)handle;
+    (void)timing;
+    return PC814_ERROR;
+#endif
+}
+
+/* Reset capture path timing */
+void pc814_reset_timing(pc814_handle_t *handle)
+{
+    if (handle != NULL) {
+        memset(&handle->timing, 0, sizeof(pc814_timing_t));
+    }
+}
+
 /* Wait for next zero-crossing */
 pc814_status_t pc814_wait_for_zc(pc814_handle_t *handle, uint32_t timeout_ms)
 {
@@ -388,15 +1394,15 @@ pc814_status_t pc814_wait_for_zc(pc814_handle_t *handle, uint32_t timeout_ms)
     uint32_t last_count = handle->data.count;
     uint32_t start_time = 0;
     
-    if (handle->port != NULL && handle->port->get_time_us != NULL) {
-        start_time = handle->port->get_time_us() / 1000;  /* Convert to ms */
+    if (PORT_READY(handle) && PORT_HAS(handle, get_time_us)) {
+        start_time = PORT_CALL(handle, get_time_us) / 1000;  /* Convert to ms */
     }
     
     while (handle->data.count == last_count) {
         if (timeout_ms > 0) {
             uint32_t current_time = 0;
-            if (handle->port != NULL && handle->port->get_time_us != NULL) {
-                current_time = handle->port->get_time_us() / 1000;
+            if (PORT_READY(handle) && PORT_HAS(handle, get_time_us)) {
+                current_time = PORT_CALL(handle, get_time_us) / 1000;
             }
             
             if ((current_time - start_time) >= timeout_ms) {
@@ -404,8 +1410,8 @@ pc814_status_t pc814_wait_for_zc(pc814_handle_t *handle, uint32_t timeout_ms)
             }
         }
         
-        if (handle->port != NULL && handle->port->delay_ms != NULL) {
-            handle->port->delay_ms(1);
+        if (PORT_READY(handle) && PORT_HAS(handle, delay_ms)) {
+            PORT_CALL_ARG(handle, delay_ms, 1);
         }
     }
     
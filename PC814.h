@@ -20,6 +20,20 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "PC814_Kalman.h"
+
+/* Supported line frequency range (Hz) */
+#define PC814_FREQ_MIN_HZ 1
+#define PC814_FREQ_MAX_HZ 5000
+
+/* Maximum listeners per event bus (listener ids are 8 bits) */
+#ifndef PC814_BUS_MAX_LISTENERS
+#define PC814_BUS_MAX_LISTENERS 8
+#endif
+
+#if PC814_BUS_MAX_LISTENERS < 1 || PC814_BUS_MAX_LISTENERS > 255
+#error "PC814_BUS_MAX_LISTENERS must be 1-255"
+#endif
 
 /* Return codes */
 typedef enum {
@@ -41,13 +55,26 @@ typedef enum {
     PC814_EDGE_FALLING = 1  /* Falling edge (high to low) */
 } pc814_edge_t;
 
+/* Line events reported through the event callback */
+typedef enum {
+    PC814_EVENT_MISSING_CYCLE = 0,   /* Expected zero-crossing did not arrive (sag/dropout) */
+    PC814_EVENT_LOSS_OF_SIGNAL = 1,  /* Consecutive missing cycles reached loss threshold */
+    PC814_EVENT_SIGNAL_RESTORED = 2, /* Zero-crossings resumed after loss of signal */
+    PC814_EVENT_FREQUENCY_LOCK = 3,  /* Auto-range locked onto source frequency */
+    PC814_EVENT_FREQUENCY_UNLOCK = 4, /* Auto-range lost lock, re-acquiring */
+    PC814_EVENT_NONE = 5             /* No line event (placeholder in event records) */
+} pc814_event_t;
+
 /* Zero-crossing data structure */
 typedef struct {
     uint32_t period_us;         /* Period between zero-crossings in microseconds */
-    uint32_t frequency_hz;      /* Line frequency in Hz (50 or 60) */
+    uint32_t frequency_hz;      /* Line frequency in Hz */
     uint32_t timestamp_us;      /* Timestamp of last zero-crossing */
     uint32_t count;             /* Total zero-crossing count */
     bool valid;                 /* Data validity flag */
+    bool synthetic;             /* Zero-crossing reconstructed by flywheel */
+    uint32_t capture_ticks;     /* Timer capture of last zero-crossing (ticks) */
+    uint32_t period_ticks;      /* Period between zero-crossings (ticks) */
 } pc814_data_t;
 
 /* Statistics structure */
@@ -55,6 +82,7 @@ typedef struct {
     uint32_t total_zc_count;    /* Total zero-crossing count */
     uint32_t valid_zc_count;    /* Valid zero-crossing count */
     uint32_t invalid_zc_count;  /* Invalid zero-crossing count */
+    uint32_t synthetic_zc_count; /* Flywheel-reconstructed zero-crossing count */
     uint32_t min_period_us;     /* Minimum period in microseconds */
     uint32_t max_period_us;     /* Maximum period in microseconds */
     uint32_t avg_period_us;     /* Average period in microseconds */
@@ -63,6 +91,73 @@ typedef struct {
     float avg_frequency_hz;     /* Average frequency in Hz */
 } pc814_statistics_t;
 
+/* Cycle watchdog status */
+typedef struct {
+    uint32_t missing_cycle_count;   /* Total missing zero-crossings */
+    uint32_t loss_count;            /* Total loss-of-signal events */
+    uint32_t restore_count;         /* Total signal-restored events */
+    uint32_t consecutive_missing;   /* Missing zero-crossings since last capture */
+    uint32_t last_missing_time_us;  /* Timestamp of last missing zero-crossing */
+    uint32_t last_loss_time_us;     /* Timestamp of last loss of signal */
+    uint32_t last_restore_time_us;  /* Timestamp of last signal restore */
+    bool signal_lost;               /* Loss-of-signal state */
+} pc814_watchdog_status_t;
+
+/* Kalman tracker output */
+typedef struct {
+    uint32_t frequency_mhz;      /* Filtered frequency in millihertz */
+    uint32_t period_us;          /* Filtered period in microseconds */
+    uint32_t period_ticks;       /* Filtered period in timer ticks */
+    uint32_t next_zc_ticks;      /* Predicted next zero-crossing (timer ticks) */
+    int32_t innovation_us;       /* Last innovation, measured - predicted (us) */
+    uint32_t innovation_abs_us;  /* Last innovation magnitude (us) */
+    uint32_t rejected_count;     /* Captures rejected by the innovation gate */
+    bool valid;                  /* Tracker locked */
+} pc814_kalman_output_t;
+
+/* Warm-start state (store in retained RAM, flash or a host file) */
+typedef struct {
+    uint32_t magic;              /* PC814_WARM_STATE_MAGIC */
+    uint32_t timer_frequency;    /* Timer clock the state was measured with */
+    uint32_t period_ticks;       /* Last valid period in timer ticks */
+    uint32_t period_us;          /* Last valid period in microseconds */
+    uint32_t expected_frequency; /* Expected line frequency (Hz) */
+    uint32_t checksum;           /* Checksum of the fields above */
+} pc814_warm_state_t;
+
+/* Lock acquisition metrics */
+typedef struct {
+    uint32_t time_to_lock_us;    /* Time from pc814_start to first valid zero-crossing */
+    uint32_t edges_to_lock;      /* Edges captured until first valid zero-crossing */
+    bool locked;                 /* First valid zero-crossing seen */
+    bool warm_started;           /* Acquisition used a warm-start state */
+} pc814_lock_info_t;
+
+#define PC814_WARM_STATE_MAGIC 0x50383134UL  /* "P814" */
+
+/* Capture path timing (filled only in PC814_INSTRUMENTATION builds) */
+typedef struct {
+    uint32_t cycle_samples;      /* Captures timed with the cycle counter */
+    uint32_t last_cycles;        /* CPU cycles in the last pc814_process_capture */
+    uint32_t min_cycles;         /* Minimum CPU cycles */
+    uint32_t max_cycles;         /* Maximum CPU cycles */
+    uint32_t mean_cycles;        /* Mean CPU cycles (computed by pc814_get_timing) */
+    uint32_t latency_samples;    /* Captures with a latency measurement */
+    uint32_t last_latency_ticks; /* Capture edge to start of processing (timer ticks) */
+    uint32_t min_latency_ticks;  /* Minimum latency (timer ticks) */
+    uint32_t max_latency_ticks;  /* Maximum latency (timer ticks) */
+    uint32_t mean_latency_ticks; /* Mean latency (computed by pc814_get_timing) */
+    uint32_t max_latency_us;     /* Maximum latency in microseconds (computed by pc814_get_timing) */
+    uint64_t cycle_sum;          /* Sum of CPU cycles */
+    uint64_t latency_sum;        /* Sum of latencies (timer ticks) */
+} pc814_timing_t;
+
+/* Extended timebase: extends a 16-bit (or narrower) timer to 32 bits */
+typedef struct {
+    uint32_t high;               /* Accumulated overflows (upper bits) */
+    uint8_t counter_bits;        /* Hardware counter width (e.g. 16 or 32) */
+} pc814_timebase_t;
+
 /* Port functions structure - user must implement */
 typedef struct {
     /* Timer input capture functions */
@@ -72,6 +167,10 @@ typedef struct {
     void (*timer_start_capture)(void);
     void (*timer_stop_capture)(void);
     
+    /* Timer output compare functions (optional, used by the cycle watchdog) */
+    void (*timer_set_compare)(uint32_t compare_value);  /* Arm compare at absolute tick */
+    void (*timer_disable_compare)(void);
+    
     /* GPIO functions for pull-up/pull-down */
     void (*gpio_set_pull_up)(void);
     void (*gpio_set_pull_down)(void);
@@ -82,27 +181,135 @@ typedef struct {
     /* Delay function */
     void (*delay_us)(uint32_t us);
     void (*delay_ms)(uint32_t ms);
+    
+    /* Instrumentation functions (optional, used with PC814_INSTRUMENTATION) */
+    uint32_t (*timer_get_counter)(void);  /* Free-running counter, same timebase as captures */
+    uint32_t (*get_cycles)(void);         /* CPU cycle counter (e.g. DWT->CYCCNT) */
 } pc814_port_t;
 
+/* Port functions with context (v2) - one implementation serves many channels */
+typedef struct {
+    /* Timer input capture functions */
+    uint32_t (*timer_get_capture_value)(void *ctx);
+    uint32_t (*timer_get_frequency)(void *ctx);
+    void (*timer_reset_capture)(void *ctx);
+    void (*timer_start_capture)(void *ctx);
+    void (*timer_stop_capture)(void *ctx);
+    
+    /* Timer output compare functions (optional, used by the cycle watchdog) */
+    void (*timer_set_compare)(void *ctx, uint32_t compare_value);
+    void (*timer_disable_compare)(void *ctx);
+    
+    /* GPIO functions for pull-up/pull-down */
+    void (*gpio_set_pull_up)(void *ctx);
+    void (*gpio_set_pull_down)(void *ctx);
+    
+    /* System time functions */
+    uint32_t (*get_time_us)(void *ctx);
+    
+    /* Delay function */
+    void (*delay_us)(void *ctx, uint32_t us);
+    void (*delay_ms)(void *ctx, uint32_t ms);
+    
+    /* Instrumentation functions (optional, used with PC814_INSTRUMENTATION) */
+    uint32_t (*timer_get_counter)(void *ctx);
+    uint32_t (*get_cycles)(void *ctx);
+} pc814_port_v2_t;
+
 /* PC814 handle structure */
+typedef struct pc814_handle_s pc814_handle_t;
+
+/* Callback function types */
+typedef void (*pc814_zc_callback_t)(pc814_handle_t *handle, pc814_data_t *data);
+typedef void (*pc814_event_callback_t)(pc814_handle_t *handle, pc814_event_t event);
+typedef void (*pc814_capture_hook_t)(void *context, pc814_handle_t *handle);
+
+/* Events delivered through an event bus */
+typedef enum {
+    PC814_BUS_VALID_ZC = 0,       /* Valid zero-crossing (measured or synthetic) */
+    PC814_BUS_INVALID_ZC = 1,     /* Edge with a period outside the tolerance (too long) */
+    PC814_BUS_GLITCH = 2,         /* Edge with a period outside the tolerance (too short) */
+    PC814_BUS_MISSING_CYCLE = 3,  /* Expected zero-crossing did not arrive */
+    PC814_BUS_LOSS = 4,           /* Loss of signal or auto-range unlock */
+    PC814_BUS_RELOCK = 5,         /* Signal restored or auto-range lock */
+    PC814_BUS_SEQUENCE_CHANGE = 6, /* Confirmed three-phase sequence change (on phase A) */
+    PC814_BUS_ANGLE_UPDATE = 7,   /* Three-phase angles updated with phase A's edge (on phase A) */
+    PC814_BUS_EVENT_COUNT = 8
+} pc814_bus_event_t;
+
+/* Event mask bits for pc814_bus_subscribe */
+#define PC814_BUS_MASK(event) ((uint16_t)(1U << (event)))
+#define PC814_BUS_MASK_ALL    ((uint16_t)((1U << PC814_BUS_EVENT_COUNT) - 1U))
+
+/* Listener function (called from interrupt context) */
+typedef void (*pc814_listener_t)(void *context, pc814_handle_t *handle,
+                                 pc814_bus_event_t event, const pc814_data_t *data);
+
+/* Event bus subscription */
+typedef struct {
+    pc814_listener_t listener;   /* Listener function (NULL = free slot) */
+    void *context;               /* Context passed to listener */
+    uint16_t mask;               /* PC814_BUS_MASK bits of subscribed events */
+    uint16_t decimation;         /* Deliver every Nth matching event (1 = all) */
+    uint16_t countdown;          /* Matching events until next delivery */
+} pc814_subscription_t;
+
+/* Event bus (may be shared by several handles) */
 typedef struct {
-    pc814_port_t *port;
+    pc814_subscription_t subscription[PC814_BUS_MAX_LISTENERS];
+    uint8_t route[PC814_BUS_EVENT_COUNT][PC814_BUS_MAX_LISTENERS]; /* Subscriptions per event */
+    uint8_t route_count[PC814_BUS_EVENT_COUNT]; /* Entries in each route */
+    uint8_t listener_count;      /* Active subscriptions */
+    bool initialized;            /* Initialization flag */
+} pc814_bus_t;
+
+struct pc814_handle_s {
+    pc814_port_t *port;           /* Port functions (v1, NULL with a v2 port) */
+    const pc814_port_v2_t *port_v2; /* Context port functions (NULL with a v1 port) */
+    void *port_ctx;               /* Context passed to each v2 port function */
     pc814_pull_t pull_config;
     pc814_edge_t edge_type;
     pc814_data_t data;
     uint32_t last_capture_time;
     uint32_t last_capture_value;
     bool initialized;
-    uint32_t expected_frequency;  /* Expected line frequency (50 or 60 Hz) */
+    uint32_t expected_frequency;  /* Expected line frequency (Hz) */
     float frequency_tolerance;    /* Frequency tolerance for validation (%) */
     pc814_zc_callback_t callback; /* Zero-crossing callback function */
     pc814_statistics_t statistics; /* Statistics data */
     uint32_t period_sum;          /* Sum of periods for average calculation */
     uint32_t period_count;        /* Count of periods for average */
-} pc814_handle_t;
-
-/* Callback function types */
-typedef void (*pc814_zc_callback_t)(pc814_handle_t *handle, pc814_data_t *data);
+    uint32_t last_period_ticks;   /* Last valid period in timer ticks */
+    uint32_t last_period_us;      /* Last valid period in microseconds */
+    pc814_event_callback_t event_callback; /* Line event callback function */
+    bool watchdog_enabled;        /* Cycle watchdog enable flag */
+    uint32_t watchdog_margin_ticks; /* Margin after predicted zero-crossing (ticks) */
+    uint32_t watchdog_loss_cycles;  /* Missing cycles before loss of signal */
+    uint32_t watchdog_compare;    /* Currently armed compare value */
+    pc814_watchdog_status_t watchdog; /* Cycle watchdog status */
+    bool flywheel_enabled;        /* Flywheel reconstruction enable flag */
+    uint32_t flywheel_max_cycles; /* Max synthesized zero-crossings per dropout */
+    uint32_t flywheel_pending;    /* Zero-crossings synthesized since last capture */
+    bool kalman_enabled;          /* Kalman tracker enable flag */
+    pc814_kalman_t kalman;        /* Kalman frequency/phase tracker */
+    bool autorange_enabled;       /* Auto-range enable flag */
+    bool autorange_locked;        /* Auto-range locked onto source */
+    uint32_t autorange_min_hz;    /* Auto-range lower bound (Hz) */
+    uint32_t autorange_max_hz;    /* Auto-range upper bound (Hz) */
+    uint32_t autorange_period_q4; /* Tracked period (us, Q4) */
+    uint32_t autorange_agree;     /* Consistent periods while acquiring */
+    uint32_t autorange_misses;    /* Consecutive invalid periods while locked */
+    bool fast_acquire;            /* Declare lock after the minimum number of edges */
+    bool warm_started;            /* Warm-start state restored */
+    bool warm_pending;            /* Restored period awaits a measured period */
+    uint32_t start_time_us;       /* Time of pc814_start */
+    pc814_lock_info_t lock_info;  /* Lock acquisition metrics */
+    pc814_timing_t timing;        /* Capture path timing (PC814_INSTRUMENTATION) */
+    pc814_capture_hook_t capture_hook; /* Module notified after each capture */
+    void *capture_hook_context;   /* Context passed to capture hook */
+    void *user_context;           /* Application/module context for callbacks */
+    pc814_bus_t *bus;             /* Event bus (NULL = none) */
+};
 
 /**
  * Initialize PC814 handle
@@ -115,6 +322,35 @@ typedef void (*pc814_zc_callback_t)(pc814_handle_t *handle, pc814_data_t *data);
 pc814_status_t pc814_init(pc814_handle_t *handle, pc814_port_t *port, 
                           pc814_pull_t pull_config, pc814_edge_t edge_type);
 
+/**
+ * Initialize PC814 handle with a context port (v2)
+ * The same port structure can be shared by any number of handles; each
+ * handle passes its own context (e.g. timer channel descriptor) to it.
+ * @param handle Pointer to handle structure
+ * @param port Pointer to context port functions structure
+ * @param ctx Context passed to every port function of this handle
+ * @param pull_config Pull-up or pull-down configuration
+ * @param edge_type Rising or falling edge detection
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_init_v2(pc814_handle_t *handle, const pc814_port_v2_t *port, void *ctx,
+                             pc814_pull_t pull_config, pc814_edge_t edge_type);
+
+/**
+ * Get port context of a handle
+ * @param handle Pointer to handle structure
+ * @return Context given to pc814_init_v2 (NULL for v1 ports)
+ */
+void *pc814_get_port_context(pc814_handle_t *handle);
+
+/**
+ * Read system time through the handle's port
+ * @param handle Pointer to handle structure
+ * @param time_us Pointer to store time in microseconds
+ * @return PC814_OK on success, PC814_ERROR if the port has no get_time_us
+ */
+pc814_status_t pc814_get_port_time_us(pc814_handle_t *handle, uint32_t *time_us);
+
 /**
  * Process Timer Input Capture (call from HAL_TIM_IC_CaptureCallback)
  * @param handle Pointer to handle structure
@@ -122,6 +358,53 @@ pc814_status_t pc814_init(pc814_handle_t *handle, pc814_port_t *port,
  */
 pc814_status_t pc814_process_capture(pc814_handle_t *handle);
 
+/**
+ * Process a capture value supplied by the caller (e.g. from a dispatching ISR)
+ * @param handle Pointer to handle structure
+ * @param capture_ticks Capture value in the handle's timebase (32-bit)
+ * @return PC814_OK when zero-crossing detected
+ */
+pc814_status_t pc814_process_capture_value(pc814_handle_t *handle, uint32_t capture_ticks);
+
+/**
+ * Record an edge whose period the caller measured and validated
+ * Same data, statistics, callback, event bus, time-to-lock, watchdog and
+ * capture hook bookkeeping as pc814_process_capture_value, without the
+ * flywheel, Kalman tracker and auto-range (used by the C++ lean path).
+ * @param handle Pointer to handle structure
+ * @param capture Capture value in timer ticks
+ * @param now Edge time in microseconds
+ * @param period_ticks Period since the previous edge (0 = no previous edge)
+ * @param period_us Period in microseconds
+ * @param valid Period within the validation bounds
+ */
+void pc814_record_capture(pc814_handle_t *handle, uint32_t capture, uint32_t now,
+                          uint32_t period_ticks, uint32_t period_us, bool valid);
+
+/**
+ * Initialize extended timebase
+ * @param timebase Pointer to timebase structure
+ * @param counter_bits Hardware counter width (1-32)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_timebase_init(pc814_timebase_t *timebase, uint8_t counter_bits);
+
+/**
+ * Register counter overflow (call from the timer update interrupt)
+ * @param timebase Pointer to timebase structure
+ */
+void pc814_timebase_overflow(pc814_timebase_t *timebase);
+
+/**
+ * Extend raw capture to 32 bits
+ * @param timebase Pointer to timebase structure
+ * @param raw_capture Raw capture register value
+ * @param overflow_pending true if an overflow flag is set but not yet counted
+ * @return Extended capture value
+ */
+uint32_t pc814_timebase_extend(const pc814_timebase_t *timebase, uint32_t raw_capture,
+                               bool overflow_pending);
+
 /**
  * Read zero-crossing data
  * @param handle Pointer to handle structure
@@ -133,7 +416,7 @@ pc814_status_t pc814_read_data(pc814_handle_t *handle, pc814_data_t *data);
 /**
  * Get line frequency
  * @param handle Pointer to handle structure
- * @return Frequency in Hz (50 or 60), 0 on error
+ * @return Frequency in Hz, 0 on error
  */
 uint32_t pc814_get_frequency(pc814_handle_t *handle);
 
@@ -161,9 +444,35 @@ uint32_t pc814_get_time_since_zc(pc814_handle_t *handle);
 /**
  * Set expected line frequency
  * @param handle Pointer to handle structure
- * @param freq Expected frequency (50 or 60 Hz)
+ * @param freq Expected frequency (PC814_FREQ_MIN_HZ to PC814_FREQ_MAX_HZ, e.g. 50, 60, 400)
+ * @return PC814_OK on success, PC814_INVALID_PARAM if out of range
+ */
+pc814_status_t pc814_set_expected_frequency(pc814_handle_t *handle, uint32_t freq);
+
+/**
+ * Enable automatic nominal-frequency detection
+ * Locks onto the source after a few consistent periods within the range and
+ * keeps the expected frequency (validation bounds) following slow drift.
+ * Data is invalid until locked; lock/unlock are reported as events.
+ * @param handle Pointer to handle structure
+ * @param min_hz Lowest accepted frequency in Hz
+ * @param max_hz Highest accepted frequency in Hz
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_autorange_enable(pc814_handle_t *handle, uint32_t min_hz, uint32_t max_hz);
+
+/**
+ * Disable automatic nominal-frequency detection (keeps last expected frequency)
+ * @param handle Pointer to handle structure
  */
-void pc814_set_expected_frequency(pc814_handle_t *handle, uint32_t freq);
+void pc814_autorange_disable(pc814_handle_t *handle);
+
+/**
+ * Check if auto-range is locked
+ * @param handle Pointer to handle structure
+ * @return true if locked onto source frequency
+ */
+bool pc814_autorange_is_locked(pc814_handle_t *handle);
 
 /**
  * Set frequency tolerance for validation
@@ -192,6 +501,219 @@ void pc814_reset(pc814_handle_t *handle);
  */
 void pc814_set_callback(pc814_handle_t *handle, pc814_zc_callback_t callback);
 
+/**
+ * Set line event callback (missing cycle, loss of signal, signal restored)
+ * @param handle Pointer to handle structure
+ * @param callback Callback function pointer (called from interrupt context)
+ */
+void pc814_set_event_callback(pc814_handle_t *handle, pc814_event_callback_t callback);
+
+/**
+ * Set capture hook (used by modules such as three-phase to run on each edge)
+ * Called from interrupt context after the handle data is updated.
+ * @param handle Pointer to handle structure
+ * @param hook Hook function pointer (NULL to remove)
+ * @param context Context pointer passed to hook
+ */
+void pc814_set_capture_hook(pc814_handle_t *handle, pc814_capture_hook_t hook, void *context);
+
+/**
+ * Set user context (read back in callbacks with pc814_get_user_context)
+ * @param handle Pointer to handle structure
+ * @param context Context pointer
+ */
+void pc814_set_user_context(pc814_handle_t *handle, void *context);
+
+/**
+ * Get user context
+ * @param handle Pointer to handle structure
+ * @return Context set with pc814_set_user_context (NULL if none)
+ */
+void *pc814_get_user_context(pc814_handle_t *handle);
+
+/**
+ * Initialize empty event bus
+ * @param bus Pointer to event bus
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_bus_init(pc814_bus_t *bus);
+
+/**
+ * Subscribe a listener to a set of events
+ * Routes are rebuilt here, so dispatch only walks the listeners of the
+ * event at hand. Subscribe before pc814_start or with the capture
+ * interrupt disabled: a publish that interrupts the rebuild may miss the
+ * event or see a partial route.
+ * @param bus Pointer to event bus
+ * @param mask PC814_BUS_MASK bits of the events to deliver
+ * @param decimation Deliver every Nth matching event (1 = every event)
+ * @param listener Listener function
+ * @param context Context pointer passed to listener
+ * @param id Pointer to store the subscription id (may be NULL)
+ * @return PC814_OK on success, PC814_ERROR if the bus is full
+ */
+pc814_status_t pc814_bus_subscribe(pc814_bus_t *bus, uint16_t mask, uint16_t decimation,
+                                   pc814_listener_t listener, void *context, uint8_t *id);
+
+/**
+ * Remove a subscription
+ * The slot is dropped from the routes before it is cleared, so a removed
+ * listener is never called; the capture interrupt rule of
+ * pc814_bus_subscribe applies.
+ * @param bus Pointer to event bus
+ * @param id Subscription id from pc814_bus_subscribe
+ * @return PC814_OK on success, PC814_INVALID_PARAM if the id is not subscribed
+ */
+pc814_status_t pc814_bus_unsubscribe(pc814_bus_t *bus, uint8_t id);
+
+/**
+ * Attach event bus to handle (runs alongside the zero-crossing and event callbacks)
+ * @param handle Pointer to handle structure
+ * @param bus Pointer to event bus (NULL to detach)
+ */
+void pc814_set_bus(pc814_handle_t *handle, pc814_bus_t *bus);
+
+/**
+ * Publish an event to the handle's bus (used by modules such as three-phase)
+ * @param handle Pointer to handle structure
+ * @param event Event to deliver
+ */
+void pc814_bus_publish(pc814_handle_t *handle, pc814_bus_event_t event);
+
+/**
+ * Enable cycle watchdog
+ * After each capture the timer compare is armed at the predicted next
+ * zero-crossing plus margin. Requires timer_set_compare in the port and a
+ * free-running timer shared by capture and compare.
+ * Reaction time is bounded by the capture edges: a missing cycle is reported
+ * one period plus margin after the last edge, and loss of signal after
+ * loss_cycles periods plus margin. Detection within half a cycle is not
+ * possible from one edge per period; use loss_cycles = 1 and a small margin
+ * for the fastest loss report (e.g. UPS transfer).
+ * With the flywheel, loss of signal is still reported after loss_cycles even
+ * if fewer than max_cycles zero-crossings have been synthesized; an edge
+ * returning within max_cycles + 1 periods is still split into single cycles.
+ * @param handle Pointer to handle structure
+ * @param margin_us Margin after predicted zero-crossing in microseconds
+ * @param loss_cycles Consecutive missing cycles before loss of signal (1 = fastest, 0 = default of 1)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_watchdog_enable(pc814_handle_t *handle, uint32_t margin_us,
+                                     uint32_t loss_cycles);
+
+/**
+ * Disable cycle watchdog
+ * @param handle Pointer to handle structure
+ */
+void pc814_watchdog_disable(pc814_handle_t *handle);
+
+/**
+ * Process timer compare match (call from HAL_TIM_OC_DelayElapsedCallback)
+ * @param handle Pointer to handle structure
+ * @return PC814_OK when a missing cycle was registered
+ */
+pc814_status_t pc814_process_compare(pc814_handle_t *handle);
+
+/**
+ * Get cycle watchdog status
+ * @param handle Pointer to handle structure
+ * @param status Pointer to status structure to fill
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_get_watchdog_status(pc814_handle_t *handle, pc814_watchdog_status_t *status);
+
+/**
+ * Check if line signal is lost
+ * @param handle Pointer to handle structure
+ * @return true if loss of signal is active
+ */
+bool pc814_is_signal_lost(pc814_handle_t *handle);
+
+/**
+ * Enable flywheel zero-crossing reconstruction
+ * Gaps of whole missing cycles are split into per-cycle periods and up to
+ * max_cycles missing zero-crossings are synthesized (data.synthetic = true)
+ * so the callback keeps firing. With the cycle watchdog enabled the
+ * synthetic zero-crossings are delivered from the compare interrupt in real
+ * time; otherwise they are delivered when the next edge arrives.
+ * If the watchdog reports loss of signal first (loss_cycles < max_cycles),
+ * the rest of the dropout is synthesized when the next edge arrives.
+ * @param handle Pointer to handle structure
+ * @param max_cycles Maximum synthesized zero-crossings per dropout (>= 1)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_flywheel_enable(pc814_handle_t *handle, uint32_t max_cycles);
+
+/**
+ * Disable flywheel zero-crossing reconstruction
+ * @param handle Pointer to handle structure
+ */
+void pc814_flywheel_disable(pc814_handle_t *handle);
+
+/**
+ * Enable Kalman frequency/phase tracker (updated on every capture)
+ * @param handle Pointer to handle structure
+ * @param process_noise_us Std. deviation of period change per cycle (us)
+ * @param measurement_noise_us Std. deviation of zero-crossing edge jitter (us)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_kalman_enable(pc814_handle_t *handle, uint32_t process_noise_us,
+                                   uint32_t measurement_noise_us);
+
+/**
+ * Disable Kalman frequency/phase tracker
+ * @param handle Pointer to handle structure
+ */
+void pc814_kalman_disable(pc814_handle_t *handle);
+
+/**
+ * Get Kalman tracker output
+ * @param handle Pointer to handle structure
+ * @param output Pointer to output structure to fill
+ * @return PC814_OK on success, PC814_ERROR if tracker not enabled or the port
+ *         has no timer_get_frequency
+ */
+pc814_status_t pc814_get_kalman_output(pc814_handle_t *handle, pc814_kalman_output_t *output);
+
+/**
+ * Save warm-start state (last valid period and expected frequency)
+ * @param handle Pointer to handle structure
+ * @param state Pointer to state structure to fill
+ * @return PC814_OK on success, PC814_ERROR if no valid period yet
+ */
+pc814_status_t pc814_save_warm_state(pc814_handle_t *handle, pc814_warm_state_t *state);
+
+/**
+ * Restore warm-start state (call after pc814_init, before pc814_start)
+ * Phase is re-established from the first edge, the period is taken from the
+ * state. State is rejected if corrupt or measured with another timer clock.
+ * Lock still needs one measured period: it is declared on the second edge if
+ * that period agrees with the restored one within the frequency tolerance,
+ * otherwise the state is dropped and acquisition continues as after a cold start.
+ * @param handle Pointer to handle structure
+ * @param state Pointer to saved state
+ * @return PC814_OK on success, PC814_INVALID_PARAM if state is rejected
+ */
+pc814_status_t pc814_warm_start(pc814_handle_t *handle, const pc814_warm_state_t *state);
+
+/**
+ * Enable/disable fast acquisition
+ * Lock is declared on the first valid period (auto-range locks on its first
+ * in-range period). A warm start needs the same single measured period,
+ * which must also confirm the restored period (see pc814_warm_start).
+ * @param handle Pointer to handle structure
+ * @param enable true to enable
+ */
+void pc814_set_fast_acquire(pc814_handle_t *handle, bool enable);
+
+/**
+ * Get lock acquisition metrics (time-to-lock)
+ * @param handle Pointer to handle structure
+ * @param info Pointer to structure to fill
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_get_lock_info(pc814_handle_t *handle, pc814_lock_info_t *info);
+
 /**
  * Start zero-crossing detection
  * @param handle Pointer to handle structure
@@ -235,6 +757,25 @@ pc814_status_t pc814_get_statistics(pc814_handle_t *handle, pc814_statistics_t *
  */
 void pc814_reset_statistics(pc814_handle_t *handle);
 
+/**
+ * Get capture path timing
+ * Cycles cover the whole of pc814_process_capture / pc814_process_capture_value,
+ * including callbacks, bus listeners and the capture hook (needs get_cycles in
+ * the port). Latency is the timer counter at entry minus the capture value,
+ * i.e. interrupt entry plus any ISR code before the call (needs
+ * timer_get_counter in the port).
+ * @param handle Pointer to handle structure
+ * @param timing Pointer to timing structure to fill
+ * @return PC814_OK on success, PC814_ERROR if built without PC814_INSTRUMENTATION
+ */
+pc814_status_t pc814_get_timing(pc814_handle_t *handle, pc814_timing_t *timing);
+
+/**
+ * Reset capture path timing
+ * @param handle Pointer to handle structure
+ */
+void pc814_reset_timing(pc814_handle_t *handle);
+
 /**
  * Wait for next zero-crossing (blocking)
  * @param handle Pointer to handle structure
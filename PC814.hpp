@@ -0,0 +1,293 @@
+/*
+ * PC814.hpp
+ * 
+ * PC814 C++17 Wrapper
+ * Zero-crossing detector bound to a static port policy and compile-time configuration
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: pc814::ZeroCross<Port, Config> wraps a pc814_handle_t. The port
+ *              is a class with static functions, the expected frequency,
+ *              tolerance and timer clock are constexpr, so the validation
+ *              bounds and tick conversions are constants in the ISR path.
+ *              The wrapped handle works with every C module (three-phase,
+ *              sync-check, ...) through handle().
+ */
+
+#ifndef PC814_HPP
+#define PC814_HPP
+
+#include "PC814.h"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace pc814 {
+
+/**
+ * Compile-time configuration
+ * @tparam ExpectedHz Expected line frequency (Hz)
+ * @tparam TolerancePercent Frequency tolerance (1-50 %)
+ * @tparam TimerHz Capture timer clock (Hz)
+ */
+template <uint32_t ExpectedHz, uint32_t TolerancePercent, uint32_t TimerHz>
+struct Config {
+    static constexpr uint32_t expected_hz = ExpectedHz;
+    static constexpr uint32_t tolerance_percent = TolerancePercent;
+    static constexpr uint32_t timer_hz = TimerHz;
+};
+
+namespace detail {
+
+/* Optional port members */
+template <typename P, typename = void> struct has_start : std::false_type {};
+template <typename P> struct has_start<P, std::void_t<decltype(P::start())>> : std::true_type {};
+
+template <typename P, typename = void> struct has_stop : std::false_type {};
+template <typename P> struct has_stop<P, std::void_t<decltype(P::stop())>> : std::true_type {};
+
+template <typename P, typename = void> struct has_set_compare : std::false_type {};
+template <typename P>
+struct has_set_compare<P, std::void_t<decltype(P::set_compare(std::declval<uint32_t>()))>> : std::true_type {};
+
+template <typename P, typename = void> struct has_disable_compare : std::false_type {};
+template <typename P> struct has_disable_compare<P, std::void_t<decltype(P::disable_compare())>> : std::true_type {};
+
+template <typename P, typename = void> struct has_pull_up : std::false_type {};
+template <typename P> struct has_pull_up<P, std::void_t<decltype(P::pull_up())>> : std::true_type {};
+
+template <typename P, typename = void> struct has_pull_down : std::false_type {};
+template <typename P> struct has_pull_down<P, std::void_t<decltype(P::pull_down())>> : std::true_type {};
+
+template <typename P, typename = void> struct has_counter : std::false_type {};
+template <typename P> struct has_counter<P, std::void_t<decltype(P::counter())>> : std::true_type {};
+
+template <typename P, typename = void> struct has_cycles : std::false_type {};
+template <typename P> struct has_cycles<P, std::void_t<decltype(P::cycles())>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * Zero-crossing detector
+ * 
+ * Port requirements (static member functions):
+ *   uint32_t capture()   - capture register of the zero-crossing edge
+ *   uint32_t time_us()   - system time in microseconds
+ * Optional: start(), stop(), pull_up(), pull_down(),
+ *           set_compare(uint32_t) and disable_compare() (cycle watchdog),
+ *           counter() and cycles() (timing of process(), PC814_INSTRUMENTATION)
+ * 
+ * on_capture() is the lean ISR path: integer period bounds check, then the
+ * core's bookkeeping (pc814_record_capture: statistics, callback, event bus,
+ * watchdog, capture hook). process() runs the full C core, adding flywheel,
+ * Kalman tracker and auto-range.
+ */
+template <typename Port, typename Cfg>
+class ZeroCross {
+public:
+    static_assert(Cfg::expected_hz >= PC814_FREQ_MIN_HZ && Cfg::expected_hz <= PC814_FREQ_MAX_HZ,
+                  "expected frequency outside PC814_FREQ_MIN_HZ..PC814_FREQ_MAX_HZ");
+    static_assert(Cfg::tolerance_percent >= 1 && Cfg::tolerance_percent <= 50,
+                  "tolerance must be 1-50 %");
+    static_assert(Cfg::timer_hz > 0, "timer clock must be non-zero");
+
+    /* Valid period range in timer ticks (frequency within tolerance) */
+    static constexpr uint32_t min_period_ticks = static_cast<uint32_t>(
+        (static_cast<uint64_t>(Cfg::timer_hz) * 100U + Cfg::expected_hz * (100U + Cfg::tolerance_percent) - 1U) /
+        (static_cast<uint64_t>(Cfg::expected_hz) * (100U + Cfg::tolerance_percent)));
+    static constexpr uint32_t max_period_ticks = static_cast<uint32_t>(
+        (static_cast<uint64_t>(Cfg::timer_hz) * 100U) /
+        (static_cast<uint64_t>(Cfg::expected_hz) * (100U - Cfg::tolerance_percent)));
+
+    static_assert(min_period_ticks > 0, "timer clock too slow for the expected frequency");
+
+    /**
+     * Convert timer ticks to microseconds (shift/multiply when the clock allows)
+     * @param ticks Timer ticks
+     * @return Microseconds
+     */
+    static constexpr uint32_t ticks_to_us(uint32_t ticks)
+    {
+        if constexpr (Cfg::timer_hz % 1000000U == 0) {
+            return ticks / (Cfg::timer_hz / 1000000U);
+        } else if constexpr (1000000U % Cfg::timer_hz == 0) {
+            return ticks * (1000000U / Cfg::timer_hz);
+        } else {
+            return static_cast<uint32_t>((static_cast<uint64_t>(ticks) * 1000000U) / Cfg::timer_hz);
+        }
+    }
+
+    /**
+     * Initialize the wrapped handle with the configured frequency and tolerance
+     * @param pull_config Pull-up or pull-down configuration
+     * @param edge_type Rising or falling edge detection
+     * @return PC814_OK on success
+     */
+    pc814_status_t init(pc814_pull_t pull_config = PC814_PULL_UP,
+                        pc814_edge_t edge_type = PC814_EDGE_RISING)
+    {
+        pc814_status_t status = pc814_init_v2(&handle_, &port_table, nullptr, pull_config, edge_type);
+        if (status != PC814_OK) {
+            return status;
+        }
+
+        pc814_set_frequency_tolerance(&handle_, static_cast<float>(Cfg::tolerance_percent));
+        return pc814_set_expected_frequency(&handle_, Cfg::expected_hz);
+    }
+
+    /**
+     * Start zero-crossing detection
+     * @return PC814_OK on success
+     */
+    pc814_status_t start() { return pc814_start(&handle_); }
+
+    /**
+     * Stop zero-crossing detection
+     */
+    void stop() { pc814_stop(&handle_); }
+
+    /**
+     * Lean capture path (call from the capture ISR)
+     * @return true when a valid zero-crossing was detected
+     */
+    bool on_capture() noexcept { return on_capture_value(Port::capture()); }
+
+    /**
+     * Lean capture path with a capture value supplied by the caller
+     * @param capture Capture value in timer ticks
+     * @return true when a valid zero-crossing was detected
+     */
+    bool on_capture_value(uint32_t capture) noexcept
+    {
+        uint32_t now = Port::time_us();
+        uint32_t last = handle_.last_capture_value;
+
+        if (last == 0 || capture == 0) {
+            pc814_record_capture(&handle_, capture, now, 0, 0, false);
+            return false;
+        }
+
+        /* Unsigned subtraction handles timer overflow */
+        uint32_t period_ticks = capture - last;
+        bool valid = (period_ticks >= min_period_ticks) && (period_ticks <= max_period_ticks);
+
+        pc814_record_capture(&handle_, capture, now, period_ticks, ticks_to_us(period_ticks), valid);
+        return valid;
+    }
+
+    /**
+     * Cycle watchdog compare match (call from the compare ISR)
+     * @return PC814_OK when a missing cycle was processed
+     */
+    pc814_status_t on_compare() noexcept { return pc814_process_compare(&handle_); }
+
+    /**
+     * Full C core capture path (flywheel, Kalman, auto-range, watchdog)
+     * @return PC814_OK when zero-crossing detected
+     */
+    pc814_status_t process() { return pc814_process_capture(&handle_); }
+
+    /**
+     * Read zero-crossing data
+     * @param data Data structure to fill
+     * @return PC814_OK if data is valid
+     */
+    pc814_status_t read(pc814_data_t &data) { return pc814_read_data(&handle_, &data); }
+
+    /**
+     * Get the wrapped C handle (for pc814_* and module functions)
+     * @return Pointer to handle
+     */
+    pc814_handle_t *handle() noexcept { return &handle_; }
+
+private:
+    static uint32_t port_capture(void *) { return Port::capture(); }
+    static uint32_t port_frequency(void *) { return Cfg::timer_hz; }
+    static uint32_t port_time_us(void *) { return Port::time_us(); }
+
+    static void port_start(void *)
+    {
+        if constexpr (detail::has_start<Port>::value) {
+            Port::start();
+        }
+    }
+
+    static void port_stop(void *)
+    {
+        if constexpr (detail::has_stop<Port>::value) {
+            Port::stop();
+        }
+    }
+
+    static void port_set_compare(void *, uint32_t compare_value)
+    {
+        if constexpr (detail::has_set_compare<Port>::value) {
+            Port::set_compare(compare_value);
+        }
+    }
+
+    static void port_disable_compare(void *)
+    {
+        if constexpr (detail::has_disable_compare<Port>::value) {
+            Port::disable_compare();
+        }
+    }
+
+    static void port_pull_up(void *)
+    {
+        if constexpr (detail::has_pull_up<Port>::value) {
+            Port::pull_up();
+        }
+    }
+
+    static void port_pull_down(void *)
+    {
+        if constexpr (detail::has_pull_down<Port>::value) {
+            Port::pull_down();
+        }
+    }
+
+    static uint32_t port_counter(void *)
+    {
+        if constexpr (detail::has_counter<Port>::value) {
+            return Port::counter();
+        } else {
+            return 0;
+        }
+    }
+
+    static uint32_t port_cycles(void *)
+    {
+        if constexpr (detail::has_cycles<Port>::value) {
+            return Port::cycles();
+        } else {
+            return 0;
+        }
+    }
+
+    /* Port table for the C core (optional members NULL when the policy lacks them) */
+    static inline const pc814_port_v2_t port_table = {
+        port_capture,
+        port_frequency,
+        nullptr,
+        detail::has_start<Port>::value ? port_start : nullptr,
+        detail::has_stop<Port>::value ? port_stop : nullptr,
+        detail::has_set_compare<Port>::value ? port_set_compare : nullptr,
+        detail::has_disable_compare<Port>::value ? port_disable_compare : nullptr,
+        detail::has_pull_up<Port>::value ? port_pull_up : nullptr,
+        detail::has_pull_down<Port>::value ? port_pull_down : nullptr,
+        port_time_us,
+        nullptr,
+        nullptr,
+        detail::has_counter<Port>::value ? port_counter : nullptr,
+        detail::has_cycles<Port>::value ? port_cycles : nullptr
+    };
+
+    pc814_handle_t handle_{};
+};
+
+} // namespace pc814
+
+#endif /* PC814_HPP */
+
@@ -0,0 +1,153 @@
+/*
+ * PC814_Dispatch.c
+ * 
+ * PC814 Capture Interrupt Dispatch Registry Implementation
+ * Maps (timer, channel) to handles for a single capture interrupt entry point
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Open-addressed timer table with bounded probing
+ */
+
+#include "PC814_Dispatch.h"
+#include <string.h>
+
+/* Home slot of a timer instance (peripheral addresses differ in middle bits) */
+static uint32_t dispatch_hash(const void *timer)
+{
+    uint32_t key = (uint32_t)(uintptr_t)timer;
+    
+    key ^= key >> 16;
+    key *= 0x45D9F3BUL;
+    key ^= key >> 16;
+    
+    return key & (PC814_DISPATCH_SLOTS - 1);
+}
+
+/* Slot of a registered timer, -1 if not registered */
+static int32_t dispatch_slot(const pc814_dispatch_t *registry, const void *timer)
+{
+    uint32_t home = dispatch_hash(timer);
+    
+    /* Never probes further than the worst registered timer */
+    for (uint32_t probe = 0; probe <= registry->max_probe; probe++) {
+        uint32_t slot = (home + probe) & (PC814_DISPATCH_SLOTS - 1);
+        if (registry->timer[slot] == timer) {
+            return (int32_t)slot;
+        }
+    }
+    
+    return -1;
+}
+
+/* Initialize registry */
+pc814_status_t pc814_dispatch_init(pc814_dispatch_t *registry)
+{
+    if (registry == NULL) {
+        return PC814_ERROR;
+    }
+    
+    memset(registry, 0, sizeof(pc814_dispatch_t));
+    registry->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Register handle for one timer channel */
+pc814_status_t pc814_dispatch_register(pc814_dispatch_t *registry, const void *timer,
+                                       uint8_t channel, pc814_handle_t *handle)
+{
+    if (registry == NULL || !registry->initialized || timer == NULL || handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    if (channel >= PC814_DISPATCH_CHANNELS) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    int32_t slot = dispatch_slot(registry, timer);
+    
+    if (slot < 0) {
+        uint32_t home = dispatch_hash(timer);
+        uint32_t probe;
+        
+        /* Slots are never freed, so the first empty slot ends the chain */
+        for (probe = 0; probe <= PC814_DISPATCH_MAX_PROBE; probe++) {
+            if (registry->timer[(home + probe) & (PC814_DISPATCH_SLOTS - 1)] == NULL) {
+                break;
+            }
+        }
+        
+        /* Longer chains would raise the ISR worst case */
+        if (probe > PC814_DISPATCH_MAX_PROBE) {
+            return PC814_ERROR;
+        }
+        
+        slot = (int32_t)((home + probe) & (PC814_DISPATCH_SLOTS - 1));
+        registry->timer[slot] = timer;
+        if (probe > registry->max_probe) {
+            registry->max_probe = (uint8_t)probe;
+        }
+    }
+    
+    registry->handle[slot][channel] = handle;
+    return PC814_OK;
+}
+
+/* Remove handle of one timer channel */
+void pc814_dispatch_unregister(pc814_dispatch_t *registry, const void *timer, uint8_t channel)
+{
+    if (registry == NULL || timer == NULL || channel >= PC814_DISPATCH_CHANNELS) {
+        return;
+    }
+    
+    /* The timer keeps its slot so other timers' probe chains stay intact */
+    int32_t slot = dispatch_slot(registry, timer);
+    if (slot >= 0) {
+        registry->handle[slot][channel] = NULL;
+    }
+}
+
+/* Find handle of one timer channel */
+pc814_handle_t *pc814_dispatch_find(const pc814_dispatch_t *registry, const void *timer,
+                                    uint8_t channel)
+{
+    if (registry == NULL || channel >= PC814_DISPATCH_CHANNELS) {
+        return NULL;
+    }
+    
+    int32_t slot = dispatch_slot(registry, timer);
+    if (slot < 0) {
+        return NULL;
+    }
+    
+    return registry->handle[slot][channel];
+}
+
+/* Dispatch capture interrupt */
+pc814_status_t pc814_dispatch_capture(const pc814_dispatch_t *registry, const void *timer,
+                                      uint8_t channel)
+{
+    pc814_handle_t *handle = pc814_dispatch_find(registry, timer, channel);
+    
+    if (handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    return pc814_process_capture(handle);
+}
+
+/* Dispatch capture value */
+pc814_status_t pc814_dispatch_capture_value(const pc814_dispatch_t *registry, const void *timer,
+                                            uint8_t channel, uint32_t capture_ticks)
+{
+    pc814_handle_t *handle = pc814_dispatch_find(registry, timer, channel);
+    
+    if (handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    return pc814_process_capture_value(handle, capture_ticks);
+}
+
@@ -0,0 +1,127 @@
+/*
+ * PC814_Dispatch.h
+ * 
+ * PC814 Capture Interrupt Dispatch Registry
+ * Maps (timer, channel) to handles for a single capture interrupt entry point
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Fixed table keyed by timer instance (any pointer, e.g. the
+ *              TIM_TypeDef base address) and channel index. The timer is
+ *              found by a hashed slot, the channel by direct index, so
+ *              dispatch cost does not grow with the number of channels.
+ *              Probing is bounded: a lookup compares at most
+ *              PC814_DISPATCH_MAX_PROBE + 1 timer slots (4 by default), and a
+ *              timer that would need a longer chain is rejected at
+ *              registration, so the ISR worst case is fixed at build time.
+ */
+
+#ifndef PC814_DISPATCH_H
+#define PC814_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Timer slots (power of two, keep about twice the number of timers) */
+#ifndef PC814_DISPATCH_SLOTS
+#define PC814_DISPATCH_SLOTS 16
+#endif
+
+/* Channels per timer */
+#ifndef PC814_DISPATCH_CHANNELS
+#define PC814_DISPATCH_CHANNELS 4
+#endif
+
+/* Slots probed past a timer's home slot (lookup worst case: this + 1 compares) */
+#ifndef PC814_DISPATCH_MAX_PROBE
+#define PC814_DISPATCH_MAX_PROBE 3
+#endif
+
+#if (PC814_DISPATCH_SLOTS & (PC814_DISPATCH_SLOTS - 1)) != 0
+#error "PC814_DISPATCH_SLOTS must be a power of two"
+#endif
+
+#if PC814_DISPATCH_MAX_PROBE >= PC814_DISPATCH_SLOTS
+#error "PC814_DISPATCH_MAX_PROBE must be less than PC814_DISPATCH_SLOTS"
+#endif
+
+/* Dispatch registry */
+typedef struct {
+    const void *timer[PC814_DISPATCH_SLOTS];     /* Timer instance per slot (NULL = free) */
+    pc814_handle_t *handle[PC814_DISPATCH_SLOTS][PC814_DISPATCH_CHANNELS]; /* Handle per channel */
+    uint8_t max_probe;           /* Longest slot probe of any registered timer */
+    bool initialized;            /* Initialization flag */
+} pc814_dispatch_t;
+
+/**
+ * Initialize empty registry
+ * @param registry Pointer to registry
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_dispatch_init(pc814_dispatch_t *registry);
+
+/**
+ * Register a handle for one timer channel (replaces an existing entry)
+ * @param registry Pointer to registry
+ * @param timer Timer instance (e.g. TIM2)
+ * @param channel Channel index (0 to PC814_DISPATCH_CHANNELS - 1)
+ * @param handle Handle processing this channel's captures
+ * @return PC814_OK on success, PC814_INVALID_PARAM for a bad channel,
+ *         PC814_ERROR if no free slot lies within PC814_DISPATCH_MAX_PROBE
+ *         of the timer's home slot (raise PC814_DISPATCH_SLOTS)
+ */
+pc814_status_t pc814_dispatch_register(pc814_dispatch_t *registry, const void *timer,
+                                       uint8_t channel, pc814_handle_t *handle);
+
+/**
+ * Remove the handle of one timer channel
+ * @param registry Pointer to registry
+ * @param timer Timer instance
+ * @param channel Channel index
+ */
+void pc814_dispatch_unregister(pc814_dispatch_t *registry, const void *timer, uint8_t channel);
+
+/**
+ * Find the handle of one timer channel
+ * @param registry Pointer to registry
+ * @param timer Timer instance
+ * @param channel Channel index
+ * @return Handle, NULL if none is registered
+ */
+pc814_handle_t *pc814_dispatch_find(const pc814_dispatch_t *registry, const void *timer,
+                                    uint8_t channel);
+
+/**
+ * Dispatch a capture interrupt (call from the timer capture ISR)
+ * The handle's port reads the capture value.
+ * @param registry Pointer to registry
+ * @param timer Timer instance that raised the interrupt
+ * @param channel Channel index
+ * @return Result of pc814_process_capture, PC814_ERROR if no handle is registered
+ */
+pc814_status_t pc814_dispatch_capture(const pc814_dispatch_t *registry, const void *timer,
+                                      uint8_t channel);
+
+/**
+ * Dispatch a capture value read by the ISR
+ * @param registry Pointer to registry
+ * @param timer Timer instance that raised the interrupt
+ * @param channel Channel index
+ * @param capture_ticks Capture value (32-bit timebase)
+ * @return Result of pc814_process_capture_value, PC814_ERROR if no handle is registered
+ */
+pc814_status_t pc814_dispatch_capture_value(const pc814_dispatch_t *registry, const void *timer,
+                                            uint8_t channel, uint32_t capture_ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_DISPATCH_H */
+
@@ -9,8 +9,13 @@
  */
 
 #include "PC814.h"
+#include "PC814_Window.h"
+#include "PC814_Jitter.h"
 #include "stm32f4xx_hal.h"
 #include <stdio.h>
+#ifdef PC814_OS_FREERTOS
+#include "PC814_RTOS.h"
+#endif
 
 /* External handles - adjust for your hardware */
 extern TIM_HandleTypeDef htim2;    /* Timer for Input Capture */
@@ -19,9 +24,6 @@ extern uint16_t PC814_GPIO_Pin;
 
 /* Timer variables for zero-crossing detection */
 static volatile uint32_t timer_capture_value = 0;
-static volatile uint32_t timer_capture_last = 0;
-static volatile uint32_t timer_period = 0;
-static volatile bool timer_capture_ready = false;
 static volatile uint32_t timer_frequency = 1000000;  /* 1MHz timer clock */
 
 /* System time variable (use HAL_GetTick or similar) */
@@ -32,12 +34,8 @@ static uint32_t system_time_us = 0;
 /* Get timer capture value */
 static uint32_t timer_get_capture_value(void)
 {
-    /* Return the period between two captures */
-    if (timer_capture_ready) {
-        timer_capture_ready = false;
-        return timer_period;
-    }
-    return timer_capture_value;  /* Fallback to single capture */
+    /* Return the raw capture of the free-running timer */
+    return timer_capture_value;
 }
 
 /* Get timer frequency */
@@ -54,9 +52,6 @@ static void timer_reset_capture(void)
     /* Reset timer capture registers and variables */
     __HAL_TIM_SET_COUNTER(&htim2, 0);
     timer_capture_value = 0;
-    timer_capture_last = 0;
-    timer_period = 0;
-    timer_capture_ready = false;
 }
 
 /* Start timer capture */
@@ -71,6 +66,19 @@ static void timer_stop_capture(void)
     HAL_TIM_IC_Stop_IT(&htim2, TIM_CHANNEL_1);
 }
 
+/* Arm output compare (channel 2) at absolute timer tick */
+static void timer_set_compare(uint32_t compare_value)
+{
+    __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_2, compare_value);
+    HAL_TIM_OC_Start_IT(&htim2, TIM_CHANNEL_2);
+}
+
+/* Disable output compare */
+static void timer_disable_compare(void)
+{
+    HAL_TIM_OC_Stop_IT(&htim2, TIM_CHANNEL_2);
+}
+
 /* Set GPIO pull-up */
 static void gpio_set_pull_up(void)
 {
@@ -115,6 +123,18 @@ static void delay_ms(uint32_t ms)
     HAL_Delay(ms);
 }
 
+/* Free-running timer counter (same timebase as the captures) */
+static uint32_t timer_get_counter(void)
+{
+    return __HAL_TIM_GET_COUNTER(&htim2);
+}
+
+/* CPU cycle counter (enable DWT: CoreDebug->DEMCR |= TRCENA, DWT->CTRL |= CYCCNTENA) */
+static uint32_t get_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
 /* Port functions structure */
 static pc814_port_t pc814_port = {
     .timer_get_capture_value = timer_get_capture_value,
@@ -122,11 +142,15 @@ static pc814_port_t pc814_port = {
     .timer_reset_capture = timer_reset_capture,
     .timer_start_capture = timer_start_capture,
     .timer_stop_capture = timer_stop_capture,
+    .timer_set_compare = timer_set_compare,
+    .timer_disable_compare = timer_disable_compare,
     .gpio_set_pull_up = gpio_set_pull_up,
     .gpio_set_pull_down = gpio_set_pull_down,
     .get_time_us = get_time_us,
     .delay_us = delay_us,
-    .delay_ms = delay_ms
+    .delay_ms = delay_ms,
+    .timer_get_counter = timer_get_counter,
+    .get_cycles = get_cycles
 };
 
 /* PC814 handle */
@@ -148,31 +172,23 @@ static pc814_handle_t pc814_handle;
 void PC814_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
 {
     if (htim->Instance == htim2.Instance) {
-        /* Read current capture value */
-        uint32_t current_capture = HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_1);
-        
-        if (timer_capture_last != 0) {
-            /* Calculate period between two captures */
-            if (current_capture > timer_capture_last) {
-                timer_period = current_capture - timer_capture_last;
-            } else {
-                /* Handle timer overflow */
-                timer_period = (0xFFFFFFFF - timer_capture_last) + current_capture;
-            }
-            timer_capture_ready = true;
-            
-            /* Process zero-crossing */
-            pc814_process_capture(&pc814_handle);
-        }
+        /* Read current capture value (timer runs free, 32-bit TIM2) */
+        timer_capture_value = HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_1);
         
-        timer_capture_last = current_capture;
-        timer_capture_value = current_capture;
-        
-        /* Reset counter for next capture */
-        __HAL_TIM_SET_COUNTER(htim, 0);
-        
-        /* Restart Input Capture */
-        HAL_TIM_IC_Start_IT(htim, TIM_CHANNEL_1);
+        /* Process zero-crossing */
+        pc814_process_capture(&pc814_handle);
+    }
+}
+
+/* 
+ * This callback must be called from HAL_TIM_OC_DelayElapsedCallback
+ * when the cycle watchdog is used (TIM2 channel 2 as output compare)
+ */
+void PC814_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == htim2.Instance &&
+        htim->Channel == HAL_TIM_ACTIVE_CHANNEL_2) {
+        pc814_process_compare(&pc814_handle);
     }
 }
 
@@ -337,6 +353,63 @@ void PC814_Example_WithCallback(void)
     /* No need to poll - just process in callback */
 }
 
+/**
+ * Line event callback function (interrupt context - keep it short)
+ */
+void PC814_LineEventCallback(pc814_handle_t *handle, pc814_event_t event)
+{
+    (void)handle;
+    
+    switch (event) {
+        case PC814_EVENT_MISSING_CYCLE:
+            /* Sag or dropout: one expected zero-crossing did not arrive */
+            break;
+        case PC814_EVENT_LOSS_OF_SIGNAL:
+            /* Loss of mains: e.g. start UPS transfer here */
+            break;
+        case PC814_EVENT_SIGNAL_RESTORED:
+            /* Mains is back */
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Example: Missing-cycle and loss-of-signal watchdog
+ */
+void PC814_Example_Watchdog(void)
+{
+    pc814_watchdog_status_t wd;
+    
+    pc814_set_event_callback(&pc814_handle, PC814_LineEventCallback);
+    
+    /* Fire 2 ms after predicted zero-crossing, loss after 2 missing cycles */
+    pc814_watchdog_enable(&pc814_handle, 2000, 2);
+    
+    if (pc814_get_watchdog_status(&pc814_handle, &wd) == PC814_OK) {
+        printf("Missing cycles: %lu\r\n", wd.missing_cycle_count);
+        printf("Loss events: %lu (last at %lu us)\r\n", wd.loss_count, wd.last_loss_time_us);
+        printf("Signal lost: %s\r\n", wd.signal_lost ? "YES" : "NO");
+    }
+}
+
+/**
+ * Example: 400 Hz ground power or variable-frequency generator
+ */
+void PC814_Example_AutoRange(void)
+{
+    /* Fixed nominal frequency other than 50/60 Hz */
+    pc814_set_expected_frequency(&pc814_handle, 400);
+    
+    /* Or lock automatically onto any source between 10 Hz and 1 kHz */
+    pc814_autorange_enable(&pc814_handle, 10, 1000);
+    
+    if (pc814_autorange_is_locked(&pc814_handle)) {
+        printf("Locked: %lu Hz\r\n", pc814_get_frequency(&pc814_handle));
+    }
+}
+
 /**
  * Example: Get statistics
  */
@@ -359,6 +432,76 @@ void PC814_Example_GetStatistics(void)
     }
 }
 
+/* Monitors fed from the handle's event bus */
+static pc814_bus_t pc814_bus;
+static pc814_windows_t pc814_windows;
+static pc814_jitter_t pc814_jitter;
+
+/**
+ * Example: Rolling frequency windows and jitter percentiles (call once after init)
+ */
+void PC814_Example_InitMonitors(void)
+{
+    pc814_bus_init(&pc814_bus);
+    pc814_windows_init(&pc814_windows, &pc814_handle);
+    pc814_windows_attach(&pc814_windows, &pc814_bus);
+    pc814_jitter_init(&pc814_jitter, &pc814_handle);
+    pc814_jitter_attach(&pc814_jitter, &pc814_bus);
+    pc814_set_bus(&pc814_handle, &pc814_bus);
+}
+
+/**
+ * Example: Report rolling frequency windows
+ */
+void PC814_Example_ReportWindows(void)
+{
+    static const char *const names[PC814_WINDOW_COUNT] = { "1 s", "1 min", "15 min" };
+    pc814_window_stats_t stats;
+    
+    for (uint32_t i = 0; i < PC814_WINDOW_COUNT; i++) {
+        if (pc814_windows_get(&pc814_windows, (pc814_window_id_t)i, &stats) == PC814_OK) {
+            printf("%s: min %.3f max %.3f mean %.3f sd %.4f Hz%s\r\n", names[i],
+                   stats.min_hz, stats.max_hz, stats.mean_hz, stats.stddev_hz,
+                   stats.complete ? "" : " (filling)");
+        }
+    }
+}
+
+/**
+ * Example: Report period jitter percentiles (alarm thresholds on the tail)
+ */
+void PC814_Example_ReportJitter(void)
+{
+    pc814_jitter_report_t report;
+    
+    if (pc814_jitter_get(&pc814_jitter, &report) == PC814_OK) {
+        printf("Period jitter: p50 %.1f p95 %.1f p99 %.1f p99.9 %.1f max %.1f us (%lu cycles)\r\n",
+               report.period_us.p50, report.period_us.p95, report.period_us.p99,
+               report.period_us.p999, report.period_us.max, report.period_us.samples);
+    }
+}
+
+/**
+ * Example: Capture path timing (build with PC814_INSTRUMENTATION)
+ */
+void PC814_Example_GetTiming(void)
+{
+    pc814_timing_t timing;
+    
+    if (pc814_get_timing(&pc814_handle, &timing) != PC814_OK) {
+        printf("Timing not available (build with PC814_INSTRUMENTATION)\r\n");
+        return;
+    }
+    
+    printf("=== PC814 Capture Timing ===\r\n");
+    printf("ISR Cycles: min %lu, mean %lu, max %lu (%lu samples)\r\n",
+           timing.min_cycles, timing.mean_cycles, timing.max_cycles, timing.cycle_samples);
+    printf("Latency: min %lu, mean %lu, max %lu ticks (max %lu us)\r\n",
+           timing.min_latency_ticks, timing.mean_latency_ticks, timing.max_latency_ticks,
+           timing.max_latency_us);
+    printf("============================\r\n");
+}
+
 /**
  * Example: Quick phase calculations
  */
@@ -373,6 +516,45 @@ void PC814_Example_QuickPhase(void)
     printf("Quarter period (90°): %lu us\r\n", quarter_period);
 }
 
+/* ========== RTOS Event Queue ========== */
+#ifdef PC814_OS_FREERTOS
+/*
+ * Zero-crossings and line events are queued from the capture interrupt;
+ * printing and other slow work run in a task. The queue depth bounds how
+ * far the task may fall behind before events are dropped.
+ */
+#define PC814_EVENT_QUEUE_DEPTH 8
+
+static pc814_rtos_publisher_t zc_publisher;
+static pc814_rtos_event_t zc_event_buffer[PC814_EVENT_QUEUE_DEPTH];
+
+/**
+ * Zero-crossing task (create with xTaskCreate after PC814_Example_Init_PullUp)
+ */
+void PC814_ZeroCrossingTask(void *argument)
+{
+    pc814_rtos_event_t event;
+    
+    (void)argument;
+    pc814_rtos_publisher_init(&zc_publisher, zc_event_buffer, PC814_EVENT_QUEUE_DEPTH);
+    pc814_rtos_attach(&zc_publisher, &pc814_handle);
+    
+    for (;;) {
+        if (pc814_rtos_wait_event(&zc_publisher, &event, PC814_OS_WAIT_FOREVER) != PC814_OK) {
+            continue;
+        }
+        
+        if (event.type == PC814_RTOS_EVENT_CROSSING) {
+            printf("ZC Task: Frequency=%lu Hz, Count=%lu\r\n",
+                   event.data.frequency_hz, event.data.count);
+        } else {
+            printf("Line event %d (dropped %lu)\r\n",
+                   (int)event.line_event, pc814_rtos_get_dropped(&zc_publisher));
+        }
+    }
+}
+#endif
+
 /* ========== Main Usage Example ========== */
 /*
 void main(void)
@@ -0,0 +1,303 @@
+/*
+ * PC814_FeederBank.c
+ * 
+ * PC814 Multi-Feeder Monitoring Bank Implementation
+ * Sequence and imbalance for many three-phase feeders in one batch pass
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Struct-of-arrays batch processing of three-phase feeders
+ */
+
+#include "PC814_FeederBank.h"
+#include <string.h>
+
+/* Default tolerance for sequence detection (degrees) */
+#define PC814_DEFAULT_BANK_TOLERANCE 10.0f
+
+/* Store one phase's zero-crossing in the bank arrays */
+static void bank_store(pc814_feeder_bank_t *bank, uint8_t p, uint8_t f, const pc814_data_t *data)
+{
+    bank->last_count[p][f] = data->count;
+    bank->zc[p][f] = data->timestamp_us;
+    bank->period[p][f] = data->period_us;
+}
+
+/* Copy new captures of one polled feeder, true if any phase changed */
+static bool bank_sample(pc814_feeder_bank_t *bank, uint8_t f)
+{
+    bool changed = false;
+    
+    for (uint8_t p = 0; p < 3; p++) {
+        const pc814_data_t *data = &bank->handle[p][f]->data;
+        
+        if (data->count == bank->last_count[p][f] || !data->valid) {
+            continue;
+        }
+        
+        bank_store(bank, p, f, data);
+        changed = true;
+    }
+    
+    return changed;
+}
+
+/* Recompute angles, sequence and imbalance of one feeder */
+static void bank_evaluate(pc814_feeder_bank_t *bank, uint8_t f)
+{
+    uint32_t bit = 1UL << f;
+    bool matched = true;
+    
+    /* Cycle-matched angle from each phase to the next, against its own period */
+    for (uint8_t from = 0; from < 3; from++) {
+        uint8_t to = (uint8_t)((from + 1) % 3);
+        uint32_t period = bank->period[from][f];
+        int32_t diff = (int32_t)(bank->zc[to][f] - bank->zc[from][f]);
+        int32_t limit = (int32_t)(period + period / 2);
+        
+        if (period == 0 || diff > limit || diff < -limit) {
+            matched = false;
+            continue;
+        }
+        
+        bank->angle[from][f] = pc814_bam_phase_angle(bank->zc[from][f], bank->zc[to][f], period);
+    }
+    
+    if (!matched) {
+        bank->valid_mask &= ~bit;
+        bank->sequence[f] = PC814_SEQUENCE_ERROR;
+        return;
+    }
+    bank->valid_mask |= bit;
+    
+    pc814_bam_t tol = bank->tolerance;
+    pc814_bam_t ab = bank->angle[PC814_PHASE_A][f];
+    pc814_bam_t bc = bank->angle[PC814_PHASE_B][f];
+    pc814_bam_t ca = bank->angle[PC814_PHASE_C][f];
+    pc814_bam_t nominal = PC814_BAM_120;
+    
+    if (pc814_bam_distance(ab, PC814_BAM_120) <= tol &&
+        pc814_bam_distance(bc, PC814_BAM_120) <= tol &&
+        pc814_bam_distance(ca, PC814_BAM_120) <= tol) {
+        bank->sequence[f] = PC814_SEQUENCE_ABC;
+    } else if (pc814_bam_distance(ab, PC814_BAM_240) <= tol &&
+               pc814_bam_distance(bc, PC814_BAM_240) <= tol &&
+               pc814_bam_distance(ca, PC814_BAM_240) <= tol) {
+        bank->sequence[f] = PC814_SEQUENCE_ACB;
+        nominal = PC814_BAM_240;
+    } else {
+        bank->sequence[f] = PC814_SEQUENCE_ERROR;
+    }
+    
+    /* Mean deviation as percentage of 120 degrees, in 0.01 % */
+    uint32_t dev_sum = (uint32_t)pc814_bam_distance(ab, nominal)
+                     + pc814_bam_distance(bc, nominal)
+                     + pc814_bam_distance(ca, nominal);
+    uint32_t imbalance = (dev_sum * 10000UL) / (3UL * PC814_BAM_120);
+    
+    bank->imbalance[f] = (imbalance > 0xFFFFUL) ? 0xFFFF : (uint16_t)imbalance;
+}
+
+/* Initialize feeder bank */
+pc814_status_t pc814_feeder_bank_init(pc814_feeder_bank_t *bank)
+{
+    if (bank == NULL) {
+        return PC814_ERROR;
+    }
+    
+    memset(bank, 0, sizeof(pc814_feeder_bank_t));
+    bank->tolerance = PC814_BAM_FROM_DEG(PC814_DEFAULT_BANK_TOLERANCE);
+    bank->stale_passes = PC814_FEEDER_BANK_STALE_PASSES;
+    bank->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Add one three-phase feeder */
+pc814_status_t pc814_feeder_bank_add(pc814_feeder_bank_t *bank,
+                                     pc814_handle_t *phase_a,
+                                     pc814_handle_t *phase_b,
+                                     pc814_handle_t *phase_c,
+                                     uint8_t *index)
+{
+    if (bank == NULL || !bank->initialized) {
+        return PC814_ERROR;
+    }
+    
+    /* All three handles, or none for a pushed feeder */
+    bool polled = (phase_a != NULL);
+    if ((phase_b != NULL) != polled || (phase_c != NULL) != polled) {
+        return PC814_ERROR;
+    }
+    
+    if (bank->feeder_count >= PC814_FEEDER_BANK_MAX) {
+        return PC814_ERROR;
+    }
+    
+    uint8_t f = bank->feeder_count;
+    bank->handle[PC814_PHASE_A][f] = phase_a;
+    bank->handle[PC814_PHASE_B][f] = phase_b;
+    bank->handle[PC814_PHASE_C][f] = phase_c;
+    
+    /* Start from the current counts: only new captures trigger an update */
+    for (uint8_t p = 0; polled && p < 3; p++) {
+        bank->last_count[p][f] = bank->handle[p][f]->data.count;
+    }
+    bank->sequence[f] = PC814_SEQUENCE_UNKNOWN;
+    bank->feeder_count++;
+    
+    if (index != NULL) {
+        *index = f;
+    }
+    
+    return PC814_OK;
+}
+
+/* Push one capture */
+pc814_status_t pc814_feeder_bank_capture(pc814_feeder_bank_t *bank, uint8_t feeder,
+                                         pc814_phase_id_t phase, const pc814_data_t *data)
+{
+    if (bank == NULL || !bank->initialized || data == NULL) {
+        return PC814_ERROR;
+    }
+    
+    if (feeder >= bank->feeder_count || (uint32_t)phase > PC814_PHASE_C) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    if (data->valid) {
+        bank_store(bank, (uint8_t)phase, feeder, data);
+        bank->push_count[feeder]++;
+    }
+    
+    return PC814_OK;
+}
+
+/* Set stale pass count */
+void pc814_feeder_bank_set_stale_passes(pc814_feeder_bank_t *bank, uint8_t passes)
+{
+    if (bank != NULL && passes > 0) {
+        bank->stale_passes = passes;
+    }
+}
+
+/* Set sequence tolerance */
+void pc814_feeder_bank_set_tolerance(pc814_feeder_bank_t *bank, float tolerance)
+{
+    if (bank != NULL && tolerance > 0.0f && tolerance <= 30.0f) {
+        bank->tolerance = PC814_BAM_FROM_DEG(tolerance);
+    }
+}
+
+/* Batch update */
+pc814_status_t pc814_feeder_bank_update(pc814_feeder_bank_t *bank,
+                                        pc814_feeder_bank_summary_t *summary)
+{
+    if (bank == NULL || !bank->initialized) {
+        return PC814_ERROR;
+    }
+    
+    pc814_feeder_bank_summary_t result;
+    uint32_t imbalance_sum = 0;
+    
+    memset(&result, 0, sizeof(result));
+    result.feeder_count = bank->feeder_count;
+    
+    for (uint8_t f = 0; f < bank->feeder_count; f++) {
+        uint32_t bit = 1UL << f;
+        
+        /* Pushed captures since the last pass (counter is only read here) */
+        uint32_t pushed = bank->push_count[f];
+        bool changed = (pushed != bank->push_seen[f]);
+        
+        if (bank->handle[PC814_PHASE_A][f] != NULL && bank_sample(bank, f)) {
+            changed = true;
+        }
+        
+        if (changed) {
+            bank->idle[f] = 0;
+            bank_evaluate(bank, f);
+            
+            /* A push during the evaluation may have mixed two cycles: redo once */
+            if (bank->push_count[f] != pushed) {
+                pushed = bank->push_count[f];
+                bank_evaluate(bank, f);
+            }
+            bank->push_seen[f] = pushed;
+            result.changed_mask |= bit;
+            result.updated++;
+        } else if (bank->idle[f] < bank->stale_passes &&
+                   ++bank->idle[f] >= bank->stale_passes &&
+                   bank->sequence[f] != PC814_SEQUENCE_UNKNOWN) {
+            /* All phases silent: the last angles no longer describe the feeder */
+            bank->valid_mask &= ~bit;
+            bank->sequence[f] = PC814_SEQUENCE_ERROR;
+        }
+        
+        /* Aggregate over every feeder, changed or not */
+        switch (bank->sequence[f]) {
+            case PC814_SEQUENCE_ABC:
+                result.abc_count++;
+                break;
+            case PC814_SEQUENCE_ACB:
+                result.acb_count++;
+                break;
+            case PC814_SEQUENCE_ERROR:
+                result.error_count++;
+                break;
+            default:
+                break;
+        }
+        
+        if (!(bank->valid_mask & bit)) {
+            continue;
+        }
+        
+        result.valid++;
+        imbalance_sum += bank->imbalance[f];
+        if (bank->imbalance[f] >= result.max_imbalance) {
+            result.max_imbalance = bank->imbalance[f];
+            result.worst_feeder = f;
+        }
+    }
+    
+    if (result.valid > 0) {
+        result.mean_imbalance = (uint16_t)(imbalance_sum / result.valid);
+    }
+    
+    if (summary != NULL) {
+        memcpy(summary, &result, sizeof(result));
+    }
+    
+    return PC814_OK;
+}
+
+/* Get sequence of one feeder */
+pc814_sequence_t pc814_feeder_bank_get_sequence(pc814_feeder_bank_t *bank, uint8_t feeder)
+{
+    if (bank == NULL || feeder >= bank->feeder_count) {
+        return PC814_SEQUENCE_ERROR;
+    }
+    return (pc814_sequence_t)bank->sequence[feeder];
+}
+
+/* Get imbalance of one feeder */
+float pc814_feeder_bank_get_imbalance(pc814_feeder_bank_t *bank, uint8_t feeder)
+{
+    if (bank == NULL || feeder >= bank->feeder_count || !(bank->valid_mask & (1UL << feeder))) {
+        return -1.0f;
+    }
+    return (float)bank->imbalance[feeder] / 100.0f;
+}
+
+/* Get angle from one phase to the next for one feeder */
+float pc814_feeder_bank_get_angle(pc814_feeder_bank_t *bank, uint8_t feeder, pc814_phase_id_t phase)
+{
+    if (bank == NULL || feeder >= bank->feeder_count || (uint32_t)phase > PC814_PHASE_C ||
+        !(bank->valid_mask & (1UL << feeder))) {
+        return 0.0f;
+    }
+    return PC814_BAM_TO_DEG(bank->angle[phase][feeder]);
+}
+
@@ -0,0 +1,178 @@
+/*
+ * PC814_FeederBank.h
+ * 
+ * PC814 Multi-Feeder Monitoring Bank
+ * Sequence and imbalance for many three-phase feeders in one batch pass
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Holds the phase state of up to PC814_FEEDER_BANK_MAX
+ *              three-phase feeders in struct-of-arrays layout. One call to
+ *              pc814_feeder_bank_update processes every feeder whose
+ *              capture count changed and reports aggregate statistics
+ *              in the same pass. All angle math is integer.
+ *              Captures are either pushed into the bank arrays from the
+ *              capture path (pc814_feeder_bank_capture, feeders added
+ *              without handles), so the batch pass reads only contiguous
+ *              arrays, or polled from each feeder's handles during the pass.
+ *              A feeder without any capture for PC814_FEEDER_BANK_STALE_PASSES
+ *              passes is dropped from the valid set.
+ */
+
+#ifndef PC814_FEEDERBANK_H
+#define PC814_FEEDERBANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include "PC814_ThreePhase.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum feeders per bank (feeder bit masks are 32 bits wide) */
+#ifndef PC814_FEEDER_BANK_MAX
+#define PC814_FEEDER_BANK_MAX 32
+#endif
+
+#if PC814_FEEDER_BANK_MAX < 1 || PC814_FEEDER_BANK_MAX > 32
+#error "PC814_FEEDER_BANK_MAX must be 1-32 (feeder bit masks are 32 bits wide)"
+#endif
+
+/* Default update passes without a capture before a feeder is stale */
+#ifndef PC814_FEEDER_BANK_STALE_PASSES
+#define PC814_FEEDER_BANK_STALE_PASSES 8
+#endif
+
+/* Aggregate result of one batch update */
+typedef struct {
+    uint8_t feeder_count;        /* Feeders in the bank */
+    uint8_t updated;             /* Feeders processed in this pass */
+    uint8_t valid;               /* Feeders with cycle-matched angles */
+    uint8_t abc_count;           /* Feeders in correct sequence */
+    uint8_t acb_count;           /* Feeders in reverse sequence */
+    uint8_t error_count;         /* Feeders with sequence error, invalid or stale data */
+    uint16_t max_imbalance;      /* Highest imbalance (0.01 %) */
+    uint16_t mean_imbalance;     /* Mean imbalance of valid feeders (0.01 %) */
+    uint8_t worst_feeder;        /* Feeder with the highest imbalance */
+    uint32_t changed_mask;       /* Bit per feeder processed in this pass */
+} pc814_feeder_bank_summary_t;
+
+/* Feeder bank (arrays indexed [phase][feeder] or [feeder]) */
+typedef struct {
+    uint8_t feeder_count;        /* Feeders added */
+    pc814_handle_t *handle[3][PC814_FEEDER_BANK_MAX];   /* Phase handles (NULL = pushed) */
+    uint32_t last_count[3][PC814_FEEDER_BANK_MAX];      /* Capture count at last update */
+    uint32_t zc[3][PC814_FEEDER_BANK_MAX];              /* Last zero-crossing (us) */
+    uint32_t period[3][PC814_FEEDER_BANK_MAX];          /* Last period (us) */
+    pc814_bam_t angle[3][PC814_FEEDER_BANK_MAX];        /* AB, BC, CA angles */
+    uint8_t sequence[PC814_FEEDER_BANK_MAX];            /* pc814_sequence_t per feeder */
+    uint16_t imbalance[PC814_FEEDER_BANK_MAX];          /* Imbalance per feeder (0.01 %) */
+    uint8_t idle[PC814_FEEDER_BANK_MAX];                /* Passes without a new capture */
+    volatile uint32_t push_count[PC814_FEEDER_BANK_MAX]; /* Pushed captures (written by capture only) */
+    uint32_t push_seen[PC814_FEEDER_BANK_MAX];          /* push_count at last update */
+    uint32_t valid_mask;         /* Bit per feeder with cycle-matched angles */
+    uint8_t stale_passes;        /* Passes without a capture before a feeder is stale */
+    pc814_bam_t tolerance;       /* Sequence tolerance (binary angle) */
+    bool initialized;            /* Initialization flag */
+} pc814_feeder_bank_t;
+
+/**
+ * Initialize empty feeder bank
+ * @param bank Pointer to feeder bank
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_feeder_bank_init(pc814_feeder_bank_t *bank);
+
+/**
+ * Add one three-phase feeder
+ * With handles the pass polls them; with all three NULL the feeder is fed
+ * by pc814_feeder_bank_capture.
+ * @param bank Pointer to feeder bank
+ * @param phase_a Handle for phase A (NULL for a pushed feeder)
+ * @param phase_b Handle for phase B (NULL for a pushed feeder)
+ * @param phase_c Handle for phase C (NULL for a pushed feeder)
+ * @param index Pointer to store the feeder index (may be NULL)
+ * @return PC814_OK on success, PC814_ERROR if the bank is full
+ */
+pc814_status_t pc814_feeder_bank_add(pc814_feeder_bank_t *bank,
+                                     pc814_handle_t *phase_a,
+                                     pc814_handle_t *phase_b,
+                                     pc814_handle_t *phase_c,
+                                     uint8_t *index);
+
+/**
+ * Push one capture into the bank arrays (from a zero-crossing callback)
+ * Call for feeders added without handles; invalid data is ignored.
+ * May interrupt pc814_feeder_bank_update: each push bumps a per-feeder
+ * counter only this function writes, so no push is lost, and a feeder whose
+ * captures change while it is being evaluated is evaluated again. All pushes
+ * for one feeder must come from the same interrupt priority (or task).
+ * @param bank Pointer to feeder bank
+ * @param feeder Feeder index
+ * @param phase Phase of the capture
+ * @param data Zero-crossing data of that phase
+ * @return PC814_OK on success, PC814_INVALID_PARAM on a bad feeder or phase
+ */
+pc814_status_t pc814_feeder_bank_capture(pc814_feeder_bank_t *bank, uint8_t feeder,
+                                         pc814_phase_id_t phase, const pc814_data_t *data);
+
+/**
+ * Set update passes without a capture before a feeder is stale
+ * @param bank Pointer to feeder bank
+ * @param passes Passes (default: PC814_FEEDER_BANK_STALE_PASSES, >= 1)
+ */
+void pc814_feeder_bank_set_stale_passes(pc814_feeder_bank_t *bank, uint8_t passes);
+
+/**
+ * Set sequence tolerance for all feeders
+ * @param bank Pointer to feeder bank
+ * @param tolerance Tolerance in degrees (default: 10.0)
+ */
+void pc814_feeder_bank_set_tolerance(pc814_feeder_bank_t *bank, float tolerance);
+
+/**
+ * Batch update (call periodically)
+ * Processes only feeders with a new capture on any phase; aggregate
+ * statistics cover all feeders. A feeder whose phases all stay silent for
+ * the stale pass count loses its valid angles and counts as an error.
+ * @param bank Pointer to feeder bank
+ * @param summary Pointer to summary to fill (may be NULL)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_feeder_bank_update(pc814_feeder_bank_t *bank,
+                                        pc814_feeder_bank_summary_t *summary);
+
+/**
+ * Get sequence of one feeder
+ * @param bank Pointer to feeder bank
+ * @param feeder Feeder index
+ * @return Sequence from the last update
+ */
+pc814_sequence_t pc814_feeder_bank_get_sequence(pc814_feeder_bank_t *bank, uint8_t feeder);
+
+/**
+ * Get imbalance of one feeder
+ * @param bank Pointer to feeder bank
+ * @param feeder Feeder index
+ * @return Imbalance percentage, negative on error
+ */
+float pc814_feeder_bank_get_imbalance(pc814_feeder_bank_t *bank, uint8_t feeder);
+
+/**
+ * Get angle from one phase to the next for one feeder
+ * @param bank Pointer to feeder bank
+ * @param feeder Feeder index
+ * @param phase Reference phase (A: A-B, B: B-C, C: C-A)
+ * @return Angle in degrees, 0 on error
+ */
+float pc814_feeder_bank_get_angle(pc814_feeder_bank_t *bank, uint8_t feeder, pc814_phase_id_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_FEEDERBANK_H */
+
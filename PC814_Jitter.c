@@ -0,0 +1,264 @@
+/*
+ * PC814_Jitter.c
+ * 
+ * PC814 Streaming Jitter Percentiles Implementation
+ * p50/p95/p99/p99.9 of period jitter and three-phase angle error
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Log-bucket histograms, integer update per cycle
+ */
+
+#include "PC814_Jitter.h"
+#include <string.h>
+
+/* Index of the highest set bit (value > 0) */
+static uint32_t msb_index(uint32_t value)
+{
+#if defined(__GNUC__)
+    return 31U - (uint32_t)__builtin_clz(value);
+#else
+    uint32_t index = 0;
+    while (value >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+
+/* Bucket of a value: exact below 8, then octave and 3-bit mantissa */
+static uint32_t bucket_index(uint32_t value)
+{
+    if (value < (1UL << PC814_HISTOGRAM_SUB_BITS)) {
+        return value;
+    }
+    
+    uint32_t shift = msb_index(value) - PC814_HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << PC814_HISTOGRAM_SUB_BITS) +
+           ((value >> shift) & ((1UL << PC814_HISTOGRAM_SUB_BITS) - 1));
+}
+
+/* Midpoint of a bucket's value range */
+static uint32_t bucket_midpoint(uint32_t index)
+{
+    if (index < (1UL << PC814_HISTOGRAM_SUB_BITS)) {
+        return index;
+    }
+    
+    uint32_t shift = (index >> PC814_HISTOGRAM_SUB_BITS) - 1;
+    uint32_t mantissa = (1UL << PC814_HISTOGRAM_SUB_BITS) + (index & ((1UL << PC814_HISTOGRAM_SUB_BITS) - 1));
+    return (mantissa << shift) + ((1UL << shift) >> 1);
+}
+
+/* Add one sample */
+void pc814_histogram_add(pc814_histogram_t *histogram, uint32_t value)
+{
+    if (histogram == NULL) {
+        return;
+    }
+    
+    if (value > PC814_HISTOGRAM_MAX_VALUE) {
+        value = PC814_HISTOGRAM_MAX_VALUE;
+    }
+    
+    histogram->bucket[bucket_index(value)]++;
+    histogram->count++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/* Get quantile */
+uint32_t pc814_histogram_quantile(const pc814_histogram_t *histogram, float quantile)
+{
+    if (histogram == NULL || histogram->count == 0) {
+        return 0;
+    }
+    
+    if (quantile < 0.0f) {
+        quantile = 0.0f;
+    } else if (quantile > 1.0f) {
+        quantile = 1.0f;
+    }
+    
+    /* Rank of the sample at the quantile (1-based) */
+    uint32_t rank = (uint32_t)(quantile * (float)histogram->count + 0.999f);
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < PC814_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->bucket[i];
+        if (seen >= rank) {
+            uint32_t mid = bucket_midpoint(i);
+            return (mid > histogram->max) ? histogram->max : mid;
+        }
+    }
+    
+    return histogram->max;
+}
+
+/* Percentiles of a histogram, scaled to output units */
+static void fill_percentiles(pc814_percentiles_t *out, const pc814_histogram_t *histogram, float scale)
+{
+    out->p50 = (float)pc814_histogram_quantile(histogram, 0.50f) * scale;
+    out->p95 = (float)pc814_histogram_quantile(histogram, 0.95f) * scale;
+    out->p99 = (float)pc814_histogram_quantile(histogram, 0.99f) * scale;
+    out->p999 = (float)pc814_histogram_quantile(histogram, 0.999f) * scale;
+    out->max = (float)histogram->max * scale;
+    out->samples = histogram->count;
+}
+
+/* Add angle errors of the confirmed sequence */
+static void add_angle_errors(pc814_jitter_t *jitter)
+{
+    pc814_threephase_t *tp = jitter->threephase;
+    pc814_bam_t nominal;
+    
+    if (!tp->relationship.valid) {
+        return;
+    }
+    
+    if (tp->sequence == PC814_SEQUENCE_ABC) {
+        nominal = PC814_BAM_120;
+    } else if (tp->sequence == PC814_SEQUENCE_ACB) {
+        nominal = PC814_BAM_240;
+    } else {
+        return;
+    }
+    
+    pc814_histogram_add(&jitter->angle, pc814_bam_distance(tp->relationship.phase_ab_bam, nominal));
+    pc814_histogram_add(&jitter->angle, pc814_bam_distance(tp->relationship.phase_bc_bam, nominal));
+    pc814_histogram_add(&jitter->angle, pc814_bam_distance(tp->relationship.phase_ca_bam, nominal));
+}
+
+/* Add one zero-crossing's period */
+static void jitter_add(pc814_jitter_t *jitter, const pc814_data_t *data)
+{
+    if (!data->valid || data->synthetic) {
+        return;
+    }
+    
+    /* Only consecutive cycles form a period pair */
+    if (jitter->last_period_ticks != 0 && data->count == jitter->last_count + 1) {
+        uint32_t a = data->period_ticks;
+        uint32_t b = jitter->last_period_ticks;
+        pc814_histogram_add(&jitter->period, (a > b) ? (a - b) : (b - a));
+    }
+    jitter->last_period_ticks = data->period_ticks;
+    jitter->last_count = data->count;
+}
+
+/* Bus listener: valid zero-crossings and three-phase angle updates of the source handle */
+static void jitter_listener(void *context, pc814_handle_t *handle,
+                            pc814_bus_event_t event, const pc814_data_t *data)
+{
+    pc814_jitter_t *jitter = (pc814_jitter_t *)context;
+    
+    if (handle != jitter->handle) {
+        return;
+    }
+    
+    /* Angles are sampled after the three-phase update, not at the crossing */
+    if (event == PC814_BUS_ANGLE_UPDATE) {
+        if (jitter->threephase != NULL) {
+            add_angle_errors(jitter);
+        }
+    } else {
+        jitter_add(jitter, data);
+    }
+}
+
+/* Initialize jitter monitor */
+pc814_status_t pc814_jitter_init(pc814_jitter_t *jitter, pc814_handle_t *handle)
+{
+    if (jitter == NULL || handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    memset(jitter, 0, sizeof(pc814_jitter_t));
+    jitter->handle = handle;
+    jitter->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Initialize jitter monitor for a three-phase system */
+pc814_status_t pc814_jitter_init_threephase(pc814_jitter_t *jitter, pc814_threephase_t *threephase)
+{
+    if (threephase == NULL) {
+        return PC814_ERROR;
+    }
+    
+    pc814_status_t status = pc814_jitter_init(jitter, threephase->phase_a);
+    if (status == PC814_OK) {
+        jitter->threephase = threephase;
+    }
+    
+    return status;
+}
+
+/* Feed monitor from an event bus */
+pc814_status_t pc814_jitter_attach(pc814_jitter_t *jitter, pc814_bus_t *bus)
+{
+    if (jitter == NULL || !jitter->initialized) {
+        return PC814_ERROR;
+    }
+    
+    uint16_t mask = PC814_BUS_MASK(PC814_BUS_VALID_ZC);
+    if (jitter->threephase != NULL) {
+        mask |= PC814_BUS_MASK(PC814_BUS_ANGLE_UPDATE);
+    }
+    
+    return pc814_bus_subscribe(bus, mask, 1, jitter_listener, jitter, NULL);
+}
+
+/* Add current zero-crossing */
+void pc814_jitter_update(pc814_jitter_t *jitter)
+{
+    if (jitter == NULL || !jitter->initialized) {
+        return;
+    }
+    
+    /* Polled: skip if this zero-crossing was already added */
+    if (jitter->handle->data.count != jitter->last_count) {
+        jitter_add(jitter, &jitter->handle->data);
+        if (jitter->threephase != NULL && jitter->handle->data.valid &&
+            !jitter->handle->data.synthetic) {
+            add_angle_errors(jitter);
+        }
+    }
+}
+
+/* Get jitter percentiles */
+pc814_status_t pc814_jitter_get(pc814_jitter_t *jitter, pc814_jitter_report_t *report)
+{
+    if (jitter == NULL || report == NULL || !jitter->initialized) {
+        return PC814_ERROR;
+    }
+    
+    /* Ticks to microseconds from the handle's last valid period */
+    float us_per_tick = 0.0f;
+    if (jitter->handle->last_period_ticks != 0) {
+        us_per_tick = (float)jitter->handle->last_period_us / (float)jitter->handle->last_period_ticks;
+    }
+    
+    fill_percentiles(&report->period_us, &jitter->period, us_per_tick);
+    fill_percentiles(&report->angle_deg, &jitter->angle, 360.0f / 65536.0f);
+    
+    return (jitter->period.count > 0) ? PC814_OK : PC814_ERROR;
+}
+
+/* Clear histograms */
+void pc814_jitter_reset(pc814_jitter_t *jitter)
+{
+    if (jitter == NULL) {
+        return;
+    }
+    
+    memset(&jitter->period, 0, sizeof(pc814_histogram_t));
+    memset(&jitter->angle, 0, sizeof(pc814_histogram_t));
+    jitter->last_period_ticks = 0;
+}
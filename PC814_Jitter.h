@@ -0,0 +1,143 @@
+/*
+ * PC814_Jitter.h
+ * 
+ * PC814 Streaming Jitter Percentiles
+ * p50/p95/p99/p99.9 of period jitter and three-phase angle error
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Fixed-bucket log histograms: each power of two is split into
+ *              8 sub-buckets, so a value is located with one bit scan and a
+ *              shift, updated with one increment, and a percentile is read
+ *              back within 1/16 (6.25 %) of the true value. Memory is
+ *              constant; counts run since init or the last reset.
+ *              Period jitter is the cycle-to-cycle period change in timer
+ *              ticks; angle error is the distance of each three-phase angle
+ *              from its nominal 120 / 240 degrees, in binary angle units.
+ */
+
+#ifndef PC814_JITTER_H
+#define PC814_JITTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include "PC814_ThreePhase.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Histogram layout: values 0-7 exact, then 8 sub-buckets per octave up to 16 bits */
+#define PC814_HISTOGRAM_SUB_BITS  3
+#define PC814_HISTOGRAM_MAX_VALUE 0xFFFFUL  /* Larger values are counted here */
+#define PC814_HISTOGRAM_BUCKETS   ((16 - PC814_HISTOGRAM_SUB_BITS + 1) << PC814_HISTOGRAM_SUB_BITS)
+
+/* Log-bucket histogram */
+typedef struct {
+    uint32_t bucket[PC814_HISTOGRAM_BUCKETS];
+    uint32_t count;              /* Samples */
+    uint32_t max;                /* Largest sample (saturated to PC814_HISTOGRAM_MAX_VALUE) */
+} pc814_histogram_t;
+
+/* Percentiles of one quantity */
+typedef struct {
+    float p50;                   /* Median */
+    float p95;                   /* 95th percentile */
+    float p99;                   /* 99th percentile */
+    float p999;                  /* 99.9th percentile */
+    float max;                   /* Largest sample */
+    uint32_t samples;            /* Samples */
+} pc814_percentiles_t;
+
+/* Jitter report */
+typedef struct {
+    pc814_percentiles_t period_us;  /* Cycle-to-cycle period change (microseconds) */
+    pc814_percentiles_t angle_deg;  /* Three-phase angle error (degrees) */
+} pc814_jitter_report_t;
+
+/* Jitter monitor */
+typedef struct {
+    pc814_handle_t *handle;      /* Period source (phase A for three-phase) */
+    pc814_threephase_t *threephase; /* Angle source (NULL = periods only) */
+    uint32_t last_period_ticks;  /* Previous period */
+    uint32_t last_count;         /* Zero-crossing count of previous period */
+    pc814_histogram_t period;    /* Period jitter (timer ticks) */
+    pc814_histogram_t angle;     /* Angle error (binary angle) */
+    bool initialized;            /* Initialization flag */
+} pc814_jitter_t;
+
+/**
+ * Add one sample to a histogram
+ * @param histogram Pointer to histogram
+ * @param value Sample (saturated to PC814_HISTOGRAM_MAX_VALUE)
+ */
+void pc814_histogram_add(pc814_histogram_t *histogram, uint32_t value);
+
+/**
+ * Get a quantile from a histogram
+ * @param histogram Pointer to histogram
+ * @param quantile Quantile (0.0-1.0, e.g. 0.99)
+ * @return Bucket midpoint of the quantile, 0 if the histogram is empty
+ */
+uint32_t pc814_histogram_quantile(const pc814_histogram_t *histogram, float quantile);
+
+/**
+ * Initialize jitter monitor for one handle (period jitter only)
+ * @param jitter Pointer to jitter monitor
+ * @param handle Source handle
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_jitter_init(pc814_jitter_t *jitter, pc814_handle_t *handle);
+
+/**
+ * Initialize jitter monitor for a three-phase system
+ * Period jitter of phase A, angle error of all three angles sampled once
+ * per cycle after the three-phase update for phase A's zero-crossing
+ * (PC814_BUS_ANGLE_UPDATE on the bus, or when polled) while the sequence
+ * is ABC or ACB.
+ * @param jitter Pointer to jitter monitor
+ * @param threephase Three-phase system
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_jitter_init_threephase(pc814_jitter_t *jitter, pc814_threephase_t *threephase);
+
+/**
+ * Feed the monitor from an event bus (valid, non-synthetic zero-crossings,
+ * plus three-phase angle updates for a three-phase monitor)
+ * Subscribes to the bus: attach before pc814_start or with the capture
+ * interrupt disabled (see pc814_bus_subscribe).
+ * @param jitter Pointer to jitter monitor
+ * @param bus Event bus attached to the source handle (phase A)
+ * @return PC814_OK on success, PC814_ERROR if the bus is full
+ */
+pc814_status_t pc814_jitter_attach(pc814_jitter_t *jitter, pc814_bus_t *bus);
+
+/**
+ * Add the source handle's current zero-crossing (when not fed from a bus)
+ * Call after the capture (and three-phase update) has been processed.
+ * @param jitter Pointer to jitter monitor
+ */
+void pc814_jitter_update(pc814_jitter_t *jitter);
+
+/**
+ * Get jitter percentiles
+ * @param jitter Pointer to jitter monitor
+ * @param report Pointer to report to fill
+ * @return PC814_OK on success, PC814_ERROR if no period jitter sample yet
+ */
+pc814_status_t pc814_jitter_get(pc814_jitter_t *jitter, pc814_jitter_report_t *report);
+
+/**
+ * Clear both histograms
+ * @param jitter Pointer to jitter monitor
+ */
+void pc814_jitter_reset(pc814_jitter_t *jitter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_JITTER_H */
+
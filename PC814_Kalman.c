@@ -0,0 +1,208 @@
+/*
+ * PC814_Kalman.c
+ *
+ * PC814 Kalman-Filter Frequency and Phase Tracker Implementation
+ *
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Fixed-point two-state Kalman filter.
+ *              Model: phase(k+1) = phase(k) + period(k), period(k+1) = period(k)
+ *              with white period noise q and measurement noise r.
+ */
+
+#include "PC814_Kalman.h"
+#include <string.h>
+
+/* Fixed-point formats */
+#define KF_Q16_ONE (1LL << 16)
+#define KF_Q8_SHIFT 8
+
+/* Innovation gate (sigma) and rejects before re-acquire */
+#define KF_GATE_SIGMA 4
+#define KF_MAX_REJECTS 4
+
+/* Maximum whole cycles bridged by one capture */
+#define KF_MAX_BRIDGE_CYCLES 16
+
+/* Advance state and covariance by one cycle */
+static void kalman_predict_step(pc814_kalman_t *kf)
+{
+    int64_t phase = (int64_t)kf->phase_frac + kf->period_q16;
+    
+    kf->phase_ticks += (uint32_t)(phase >> 16);
+    kf->phase_frac = (int32_t)(phase & 0xFFFF);
+    
+    /* P = F P F' + Q, Q = q * [1/4 1/2; 1/2 1] */
+    kf->p00 += 2 * kf->p01 + kf->p11 + kf->q / 4;
+    kf->p01 += kf->p11 + kf->q / 2;
+    kf->p11 += kf->q;
+}
+
+/* Restart from a single capture */
+static void kalman_acquire(pc814_kalman_t *kf, uint32_t capture_ticks)
+{
+    kf->phase_ticks = capture_ticks;
+    kf->phase_frac = 0;
+    kf->consecutive_rejects = 0;
+    kf->state = PC814_KALMAN_ACQUIRE;
+}
+
+/* Initialize Kalman filter */
+void pc814_kalman_init(pc814_kalman_t *kf, uint32_t process_noise_ticks,
+                       uint32_t measurement_noise_ticks)
+{
+    if (kf == NULL) {
+        return;
+    }
+    
+    memset(kf, 0, sizeof(pc814_kalman_t));
+    kf->q = ((int64_t)process_noise_ticks * process_noise_ticks) << KF_Q8_SHIFT;
+    kf->r = ((int64_t)measurement_noise_ticks * measurement_noise_ticks) << KF_Q8_SHIFT;
+    
+    /* Keep variances non-zero so gains stay defined */
+    if (kf->q == 0) {
+        kf->q = 1;
+    }
+    if (kf->r == 0) {
+        kf->r = 1 << KF_Q8_SHIFT;
+    }
+    
+    kf->state = PC814_KALMAN_EMPTY;
+}
+
+/* Update filter with a capture */
+bool pc814_kalman_update(pc814_kalman_t *kf, uint32_t capture_ticks)
+{
+    if (kf == NULL) {
+        return false;
+    }
+    
+    if (kf->state == PC814_KALMAN_EMPTY) {
+        kalman_acquire(kf, capture_ticks);
+        return true;
+    }
+    
+    if (kf->state == PC814_KALMAN_ACQUIRE) {
+        uint32_t period = capture_ticks - kf->phase_ticks;
+        if (period == 0) {
+            return false;
+        }
+        
+        /* Two-point initialization: period from difference of two captures */
+        kf->period_q16 = (int64_t)period << 16;
+        kf->phase_ticks = capture_ticks;
+        kf->phase_frac = 0;
+        kf->p00 = kf->r;
+        kf->p01 = kf->r;
+        kf->p11 = 2 * kf->r;
+        kf->innovation = 0;
+        kf->update_count++;
+        kf->state = PC814_KALMAN_TRACKING;
+        return true;
+    }
+    
+    /* Save state so a rejected capture leaves the filter untouched */
+    pc814_kalman_t saved = *kf;
+    
+    /* Predict; bridge missing edges by predicting whole cycles */
+    int64_t half_period = kf->period_q16 / 2;
+    int64_t y;
+    uint32_t cycles = 0;
+    
+    do {
+        kalman_predict_step(kf);
+        cycles++;
+        y = ((int64_t)(int32_t)(capture_ticks - kf->phase_ticks) << 16) - kf->phase_frac;
+    } while (y > half_period && cycles < KF_MAX_BRIDGE_CYCLES);
+    
+    /* Innovation gate: y^2 > (sigma^2) * S */
+    int64_t s = kf->p00 + kf->r;
+    int64_t y_ticks = y >> 16;
+    if (y > half_period ||
+        ((y_ticks * y_ticks) << KF_Q8_SHIFT) > (int64_t)(KF_GATE_SIGMA * KF_GATE_SIGMA) * s) {
+        uint32_t rejects = saved.consecutive_rejects + 1;
+        *kf = saved;
+        kf->rejected_count++;
+        kf->consecutive_rejects = rejects;
+        
+        /* Persistent disagreement: frequency step or re-sync, re-acquire */
+        if (rejects >= KF_MAX_REJECTS) {
+            kalman_acquire(kf, capture_ticks);
+        }
+        return false;
+    }
+    
+    /* Gains (Q16) */
+    int64_t k0 = (kf->p00 << 16) / s;
+    int64_t k1 = (kf->p01 << 16) / s;
+    
+    /* State update */
+    int64_t phase = (int64_t)kf->phase_frac + ((k0 * y) >> 16);
+    kf->phase_ticks += (uint32_t)(int32_t)(phase >> 16);
+    kf->phase_frac = (int32_t)(phase & 0xFFFF);
+    kf->period_q16 += (k1 * y) >> 16;
+    
+    /* Covariance update: P = (I - K H) P */
+    int64_t p01 = kf->p01;
+    kf->p11 -= (k1 * p01) >> 16;
+    kf->p01 -= (k0 * p01) >> 16;
+    kf->p00 -= (k0 * kf->p00) >> 16;
+    
+    kf->innovation = (int32_t)y_ticks;
+    kf->consecutive_rejects = 0;
+    kf->update_count++;
+    
+    return true;
+}
+
+/* Start tracking from a single capture and a known period */
+void pc814_kalman_seed(pc814_kalman_t *kf, uint32_t capture_ticks, uint32_t period_ticks)
+{
+    if (kf == NULL || period_ticks == 0) {
+        return;
+    }
+    
+    /* Phase from this edge, period uncertain by the measurement noise */
+    kf->period_q16 = (int64_t)period_ticks << 16;
+    kf->phase_ticks = capture_ticks;
+    kf->phase_frac = 0;
+    kf->p00 = kf->r;
+    kf->p01 = 0;
+    kf->p11 = kf->r;
+    kf->innovation = 0;
+    kf->consecutive_rejects = 0;
+    kf->state = PC814_KALMAN_TRACKING;
+}
+
+/* Predict zero-crossing time */
+uint32_t pc814_kalman_predict(const pc814_kalman_t *kf, uint32_t cycles)
+{
+    if (kf == NULL || kf->state != PC814_KALMAN_TRACKING) {
+        return 0;
+    }
+    
+    int64_t offset = (int64_t)kf->phase_frac + kf->period_q16 * cycles + KF_Q16_ONE / 2;
+    return kf->phase_ticks + (uint32_t)(offset >> 16);
+}
+
+/* Get filtered period */
+uint32_t pc814_kalman_get_period_ticks(const pc814_kalman_t *kf)
+{
+    if (kf == NULL || kf->state != PC814_KALMAN_TRACKING || kf->period_q16 <= 0) {
+        return 0;
+    }
+    
+    return (uint32_t)((kf->period_q16 + KF_Q16_ONE / 2) >> 16);
+}
+
+/* Get filtered frequency */
+uint32_t pc814_kalman_get_frequency_mhz(const pc814_kalman_t *kf, uint32_t timer_freq)
+{
+    if (kf == NULL || kf->state != PC814_KALMAN_TRACKING || kf->period_q16 <= 0) {
+        return 0;
+    }
+    
+    /* f = timer_freq / period, in mHz with Q16 period */
+    return (uint32_t)((((uint64_t)timer_freq * 1000ULL) << 16) / (uint64_t)kf->period_q16);
+}
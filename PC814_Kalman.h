@@ -0,0 +1,103 @@
+/*
+ * PC814_Kalman.h
+ *
+ * PC814 Kalman-Filter Frequency and Phase Tracker
+ * Two-state (phase, period) fixed-point Kalman filter on timer captures
+ *
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Alternative estimator to the raw per-cycle period.
+ *              State is the time of the last zero-crossing and the period,
+ *              both in timer ticks. No floating point is used.
+ */
+
+#ifndef PC814_KALMAN_H
+#define PC814_KALMAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Filter state */
+typedef enum {
+    PC814_KALMAN_EMPTY = 0,      /* No capture yet */
+    PC814_KALMAN_ACQUIRE = 1,    /* First capture seen, period unknown */
+    PC814_KALMAN_TRACKING = 2    /* Phase and period tracked */
+} pc814_kalman_state_t;
+
+/* Kalman filter structure (fixed point) */
+typedef struct {
+    uint32_t phase_ticks;        /* Estimated last zero-crossing (timer ticks) */
+    int32_t phase_frac;          /* Fractional part of phase (Q16, 0..65535) */
+    int64_t period_q16;          /* Estimated period (timer ticks, Q16) */
+    int64_t p00;                 /* Phase variance (ticks^2, Q8) */
+    int64_t p01;                 /* Phase/period covariance (ticks^2, Q8) */
+    int64_t p11;                 /* Period variance (ticks^2, Q8) */
+    int64_t q;                   /* Process noise: period change variance per cycle (Q8) */
+    int64_t r;                   /* Measurement noise: edge jitter variance (Q8) */
+    int32_t innovation;          /* Last innovation, measured - predicted (ticks) */
+    uint32_t rejected_count;     /* Captures rejected by the innovation gate */
+    uint32_t consecutive_rejects; /* Rejected captures since last accepted one */
+    uint32_t update_count;       /* Accepted captures */
+    pc814_kalman_state_t state;  /* Filter state */
+} pc814_kalman_t;
+
+/**
+ * Initialize Kalman filter
+ * @param kf Pointer to filter structure
+ * @param process_noise_ticks Std. deviation of period change per cycle (ticks)
+ * @param measurement_noise_ticks Std. deviation of capture jitter (ticks)
+ */
+void pc814_kalman_init(pc814_kalman_t *kf, uint32_t process_noise_ticks,
+                       uint32_t measurement_noise_ticks);
+
+/**
+ * Update filter with a capture (call once per zero-crossing edge)
+ * Missing edges are bridged by predicting whole cycles; outliers beyond
+ * 4 sigma are rejected.
+ * @param kf Pointer to filter structure
+ * @param capture_ticks Raw capture value of free-running timer
+ * @return true if the capture was accepted
+ */
+bool pc814_kalman_update(pc814_kalman_t *kf, uint32_t capture_ticks);
+
+/**
+ * Start tracking from a single capture and a known period (warm start)
+ * @param kf Pointer to filter structure (initialized)
+ * @param capture_ticks Raw capture value of the first edge
+ * @param period_ticks Last-known period in timer ticks
+ */
+void pc814_kalman_seed(pc814_kalman_t *kf, uint32_t capture_ticks, uint32_t period_ticks);
+
+/**
+ * Predict zero-crossing time
+ * @param kf Pointer to filter structure
+ * @param cycles Number of cycles after the last zero-crossing (1 = next)
+ * @return Predicted zero-crossing in timer ticks
+ */
+uint32_t pc814_kalman_predict(const pc814_kalman_t *kf, uint32_t cycles);
+
+/**
+ * Get filtered period
+ * @param kf Pointer to filter structure
+ * @return Period in timer ticks (rounded), 0 if not tracking
+ */
+uint32_t pc814_kalman_get_period_ticks(const pc814_kalman_t *kf);
+
+/**
+ * Get filtered frequency
+ * @param kf Pointer to filter structure
+ * @param timer_freq Timer clock frequency in Hz
+ * @return Frequency in millihertz, 0 if not tracking
+ */
+uint32_t pc814_kalman_get_frequency_mhz(const pc814_kalman_t *kf, uint32_t timer_freq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_KALMAN_H */
@@ -0,0 +1,113 @@
+/*
+ * PC814_OS.h
+ * 
+ * PC814 Operating System Abstraction
+ * Queue, critical section and tick for RTOS integration
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Select one backend at compile time:
+ *              PC814_OS_FREERTOS - FreeRTOS (static allocation, from-ISR calls)
+ *              PC814_OS_POSIX    - POSIX threads (host builds and tests)
+ *              All objects are statically allocated by the caller; queue
+ *              storage is supplied at creation.
+ */
+
+#ifndef PC814_OS_H
+#define PC814_OS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Timeout value: wait until available */
+#define PC814_OS_WAIT_FOREVER 0xFFFFFFFFUL
+
+#if defined(PC814_OS_FREERTOS)
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+/* Message queue */
+typedef struct {
+    QueueHandle_t handle;        /* FreeRTOS queue */
+    StaticQueue_t control;       /* Queue control block */
+} pc814_os_queue_t;
+
+#elif defined(PC814_OS_POSIX)
+
+#include <pthread.h>
+
+/* Message queue (ring buffer guarded by a mutex) */
+typedef struct {
+    pthread_mutex_t lock;        /* Buffer lock */
+    pthread_cond_t not_empty;    /* Signalled on send */
+    uint8_t *buffer;             /* Item storage (depth * item_size bytes) */
+    uint32_t item_size;          /* Bytes per item */
+    uint32_t depth;              /* Items the buffer holds */
+    uint32_t head;               /* Next item to receive */
+    uint32_t count;              /* Items queued */
+} pc814_os_queue_t;
+
+#else
+#error "PC814_OS.h: define PC814_OS_FREERTOS or PC814_OS_POSIX"
+#endif
+
+/**
+ * Create message queue over caller storage
+ * @param queue Pointer to queue
+ * @param buffer Storage of depth * item_size bytes
+ * @param item_size Bytes per item
+ * @param depth Maximum queued items
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_os_queue_create(pc814_os_queue_t *queue, void *buffer,
+                                     uint32_t item_size, uint32_t depth);
+
+/**
+ * Send item without blocking (safe from interrupt context)
+ * @param queue Pointer to queue
+ * @param item Item to copy into the queue
+ * @return true if queued, false if the queue is full
+ */
+bool pc814_os_queue_send_from_isr(pc814_os_queue_t *queue, const void *item);
+
+/**
+ * Receive item (task context)
+ * @param queue Pointer to queue
+ * @param item Buffer for the item
+ * @param timeout_ms Maximum wait (0 = poll, PC814_OS_WAIT_FOREVER = no limit)
+ * @return PC814_OK if an item was received, PC814_ERROR on timeout
+ */
+pc814_status_t pc814_os_queue_receive(pc814_os_queue_t *queue, void *item, uint32_t timeout_ms);
+
+/**
+ * Enter critical section (task or interrupt context)
+ * @return State to pass to pc814_os_critical_exit
+ */
+uint32_t pc814_os_critical_enter(void);
+
+/**
+ * Leave critical section
+ * @param state Value returned by pc814_os_critical_enter
+ */
+void pc814_os_critical_exit(uint32_t state);
+
+/**
+ * Get OS tick in milliseconds
+ * @return Milliseconds since scheduler start (wraps)
+ */
+uint32_t pc814_os_tick_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_OS_H */
+
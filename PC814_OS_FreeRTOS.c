@@ -0,0 +1,84 @@
+/*
+ * PC814_OS_FreeRTOS.c
+ * 
+ * PC814 Operating System Abstraction - FreeRTOS Backend
+ * Queue, critical section and tick on FreeRTOS
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Build with PC814_OS_FREERTOS and configSUPPORT_STATIC_ALLOCATION
+ */
+
+#if defined(PC814_OS_FREERTOS)
+
+#include "PC814_OS.h"
+#include <stddef.h>
+
+/* Milliseconds to ticks, PC814_OS_WAIT_FOREVER blocks indefinitely */
+static TickType_t timeout_ticks(uint32_t timeout_ms)
+{
+    if (timeout_ms == PC814_OS_WAIT_FOREVER) {
+        return portMAX_DELAY;
+    }
+    return pdMS_TO_TICKS(timeout_ms);
+}
+
+/* Create message queue */
+pc814_status_t pc814_os_queue_create(pc814_os_queue_t *queue, void *buffer,
+                                     uint32_t item_size, uint32_t depth)
+{
+    if (queue == NULL || buffer == NULL || item_size == 0 || depth == 0) {
+        return PC814_ERROR;
+    }
+    
+    queue->handle = xQueueCreateStatic(depth, item_size, (uint8_t *)buffer, &queue->control);
+    return (queue->handle != NULL) ? PC814_OK : PC814_ERROR;
+}
+
+/* Send item from interrupt */
+bool pc814_os_queue_send_from_isr(pc814_os_queue_t *queue, const void *item)
+{
+    BaseType_t woken = pdFALSE;
+    bool sent = (xQueueSendFromISR(queue->handle, item, &woken) == pdTRUE);
+    
+    portYIELD_FROM_ISR(woken);
+    return sent;
+}
+
+/* Receive item */
+pc814_status_t pc814_os_queue_receive(pc814_os_queue_t *queue, void *item, uint32_t timeout_ms)
+{
+    if (queue == NULL || item == NULL) {
+        return PC814_ERROR;
+    }
+    
+    return (xQueueReceive(queue->handle, item, timeout_ticks(timeout_ms)) == pdTRUE) ?
+           PC814_OK : PC814_ERROR;
+}
+
+/* Enter critical section */
+uint32_t pc814_os_critical_enter(void)
+{
+    return (uint32_t)taskENTER_CRITICAL_FROM_ISR();
+}
+
+/* Leave critical section */
+void pc814_os_critical_exit(uint32_t state)
+{
+    taskEXIT_CRITICAL_FROM_ISR((UBaseType_t)state);
+}
+
+/* Get OS tick in milliseconds */
+uint32_t pc814_os_tick_ms(void)
+{
+    return (uint32_t)(((uint64_t)xTaskGetTickCountFromISR() * 1000U) / configTICK_RATE_HZ);
+}
+
+#else
+
+/* Keep the translation unit non-empty when another backend is selected */
+typedef int pc814_os_freertos_unused_t;
+
+#endif /* PC814_OS_FREERTOS */
+
@@ -0,0 +1,162 @@
+/*
+ * PC814_OS_POSIX.c
+ * 
+ * PC814 Operating System Abstraction - POSIX Threads Backend
+ * Queue, critical section and tick on pthreads
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Build with PC814_OS_POSIX for host builds and tests; the
+ *              thread that feeds captures plays the interrupt role
+ */
+
+#if defined(PC814_OS_POSIX)
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "PC814_OS.h"
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+/* Lock standing in for interrupt masking */
+static pthread_mutex_t critical_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Condition variable on the monotonic clock */
+static void cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/* Absolute deadline timeout_ms from now */
+static struct timespec deadline_after(uint32_t timeout_ms)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += (time_t)(timeout_ms / 1000U);
+    ts.tv_nsec += (long)(timeout_ms % 1000U) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    
+    return ts;
+}
+
+/* Wait on condition, false on timeout (mutex held) */
+static bool cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, uint32_t timeout_ms,
+                      const struct timespec *deadline)
+{
+    if (timeout_ms == 0) {
+        return false;
+    }
+    
+    if (timeout_ms == PC814_OS_WAIT_FOREVER) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+/* Create message queue */
+pc814_status_t pc814_os_queue_create(pc814_os_queue_t *queue, void *buffer,
+                                     uint32_t item_size, uint32_t depth)
+{
+    if (queue == NULL || buffer == NULL || item_size == 0 || depth == 0) {
+        return PC814_ERROR;
+    }
+    
+    pthread_mutex_init(&queue->lock, NULL);
+    cond_init(&queue->not_empty);
+    queue->buffer = (uint8_t *)buffer;
+    queue->item_size = item_size;
+    queue->depth = depth;
+    queue->head = 0;
+    queue->count = 0;
+    
+    return PC814_OK;
+}
+
+/* Send item from interrupt */
+bool pc814_os_queue_send_from_isr(pc814_os_queue_t *queue, const void *item)
+{
+    pthread_mutex_lock(&queue->lock);
+    
+    if (queue->count == queue->depth) {
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+    
+    uint32_t tail = (queue->head + queue->count) % queue->depth;
+    memcpy(&queue->buffer[tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return true;
+}
+
+/* Receive item */
+pc814_status_t pc814_os_queue_receive(pc814_os_queue_t *queue, void *item, uint32_t timeout_ms)
+{
+    if (queue == NULL || item == NULL) {
+        return PC814_ERROR;
+    }
+    
+    struct timespec deadline = deadline_after(timeout_ms);
+    
+    pthread_mutex_lock(&queue->lock);
+    
+    while (queue->count == 0) {
+        if (!cond_wait(&queue->not_empty, &queue->lock, timeout_ms, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return PC814_ERROR;
+        }
+    }
+    
+    memcpy(item, &queue->buffer[queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->depth;
+    queue->count--;
+    
+    pthread_mutex_unlock(&queue->lock);
+    return PC814_OK;
+}
+
+/* Enter critical section */
+uint32_t pc814_os_critical_enter(void)
+{
+    pthread_mutex_lock(&critical_lock);
+    return 0;
+}
+
+/* Leave critical section */
+void pc814_os_critical_exit(uint32_t state)
+{
+    (void)state;
+    pthread_mutex_unlock(&critical_lock);
+}
+
+/* Get OS tick in milliseconds */
+uint32_t pc814_os_tick_ms(void)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U);
+}
+
+#else
+
+/* Keep the translation unit non-empty when another backend is selected */
+typedef int pc814_os_posix_unused_t;
+
+#endif /* PC814_OS_POSIX */
+
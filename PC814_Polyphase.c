@@ -0,0 +1,393 @@
+/*
+ * PC814_Polyphase.c
+ * 
+ * PC814 Polyphase (N-Phase) System Support Implementation
+ * Phase angles and sequence for systems with any number of phases
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: All angle math is done in 16-bit binary angles
+ */
+
+#include "PC814_Polyphase.h"
+#include <string.h>
+
+/* Default tolerance for sequence detection (degrees) */
+#define PC814_DEFAULT_POLY_TOLERANCE 10.0f
+
+/* Mask with one bit per phase */
+static uint32_t all_phases(const pc814_polyphase_t *polyphase)
+{
+    return (polyphase->phase_count >= 32) ? 0xFFFFFFFFUL : ((1UL << polyphase->phase_count) - 1UL);
+}
+
+/* Cycle-matched angle of one phase after the reference phase */
+static void update_angle(pc814_polyphase_t *polyphase, uint8_t phase)
+{
+    uint32_t bit = 1UL << phase;
+    uint32_t period = polyphase->phase_period[0];
+    
+    if (phase == 0) {
+        polyphase->angle[0] = 0;
+        polyphase->angle_valid |= bit;
+        return;
+    }
+    
+    if (period == 0 || !(polyphase->phase_seen & 1UL)) {
+        polyphase->angle_valid &= ~bit;
+        return;
+    }
+    
+    int32_t diff = (int32_t)(polyphase->phase_zc[phase] - polyphase->phase_zc[0]);
+    int32_t limit = (int32_t)(period + period / 2);
+    if (diff > limit || diff < -limit) {
+        polyphase->angle_valid &= ~bit;
+        return;
+    }
+    
+    polyphase->angle[phase] = pc814_bam_phase_angle(polyphase->phase_zc[0], polyphase->phase_zc[phase], period);
+    polyphase->angle_valid |= bit;
+}
+
+/* Reference edge: drop phases whose last edge is too old to pair with it */
+static void expire_stale(pc814_polyphase_t *polyphase)
+{
+    uint32_t period = polyphase->phase_period[0];
+    int32_t limit = (int32_t)(period + period / 2);
+    
+    for (uint8_t i = 1; i < polyphase->phase_count; i++) {
+        if ((int32_t)(polyphase->phase_zc[0] - polyphase->phase_zc[i]) > limit) {
+            polyphase->angle_valid &= ~(1UL << i);
+        }
+    }
+}
+
+/* Event-driven update: refresh one phase and its angle to the reference */
+static void polyphase_update_phase(pc814_polyphase_t *polyphase, uint8_t phase,
+                                   const pc814_data_t *data)
+{
+    if (!data->valid) {
+        return;
+    }
+    
+    /* Shared timebase: full timer resolution, otherwise system time */
+    polyphase->phase_zc[phase] = (polyphase->timebase != NULL) ? data->capture_ticks : data->timestamp_us;
+    polyphase->phase_period[phase] = (polyphase->timebase != NULL) ? data->period_ticks : data->period_us;
+    polyphase->phase_seen |= 1UL << phase;
+    
+    if (phase == 0) {
+        expire_stale(polyphase);
+    }
+    update_angle(polyphase, phase);
+    
+    polyphase->last_update_time = data->timestamp_us;
+    
+    if (polyphase->callback != NULL) {
+        polyphase->callback(polyphase, phase);
+    }
+}
+
+/* Capture hook installed on each phase handle */
+static void polyphase_capture_hook(void *context, pc814_handle_t *handle)
+{
+    pc814_polyphase_t *polyphase = (pc814_polyphase_t *)context;
+    
+    for (uint8_t i = 0; i < polyphase->phase_count; i++) {
+        if (polyphase->phases[i] == handle) {
+            polyphase_update_phase(polyphase, i, &handle->data);
+            return;
+        }
+    }
+}
+
+/* Initialize polyphase system */
+pc814_status_t pc814_polyphase_init(pc814_polyphase_t *polyphase,
+                                    pc814_handle_t *const *phases,
+                                    uint8_t phase_count)
+{
+    if (polyphase == NULL || phases == NULL) {
+        return PC814_ERROR;
+    }
+    
+    if (phase_count < 2 || phase_count > PC814_POLYPHASE_MAX_PHASES) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    for (uint8_t i = 0; i < phase_count; i++) {
+        if (phases[i] == NULL) {
+            return PC814_ERROR;
+        }
+    }
+    
+    memset(polyphase, 0, sizeof(pc814_polyphase_t));
+    for (uint8_t i = 0; i < phase_count; i++) {
+        polyphase->phases[i] = phases[i];
+        polyphase->nominal[i] = (pc814_bam_t)((65536UL * i) / phase_count);
+    }
+    polyphase->phase_count = phase_count;
+    polyphase->tolerance = PC814_BAM_FROM_DEG(PC814_DEFAULT_POLY_TOLERANCE);
+    polyphase->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Set nominal angle of one phase */
+pc814_status_t pc814_polyphase_set_nominal_angle(pc814_polyphase_t *polyphase,
+                                                 uint8_t phase,
+                                                 float angle_deg)
+{
+    if (polyphase == NULL || !polyphase->initialized) {
+        return PC814_ERROR;
+    }
+    
+    if (phase == 0 || phase >= polyphase->phase_count || angle_deg < 0.0f || angle_deg >= 360.0f) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    polyphase->nominal[phase] = PC814_BAM_FROM_DEG(angle_deg);
+    return PC814_OK;
+}
+
+/* Set sequence tolerance */
+void pc814_polyphase_set_tolerance(pc814_polyphase_t *polyphase, float tolerance)
+{
+    if (polyphase != NULL && tolerance > 0.0f && tolerance <= 30.0f) {
+        polyphase->tolerance = PC814_BAM_FROM_DEG(tolerance);
+    }
+}
+
+/* Process polyphase system */
+pc814_status_t pc814_polyphase_process(pc814_polyphase_t *polyphase)
+{
+    if (polyphase == NULL || !polyphase->initialized) {
+        return PC814_ERROR;
+    }
+    
+    pc814_data_t data;
+    uint32_t fresh = 0;
+    
+    for (uint8_t i = 0; i < polyphase->phase_count; i++) {
+        /* A phase without valid data is skipped and its angle dropped below */
+        if (pc814_read_data(polyphase->phases[i], &data) != PC814_OK || !data.valid) {
+            continue;
+        }
+        polyphase->phase_zc[i] = data.timestamp_us;
+        polyphase->phase_period[i] = data.period_us;
+        polyphase->phase_seen |= 1UL << i;
+        fresh |= 1UL << i;
+        
+        if (i == 0) {
+            polyphase->last_update_time = data.timestamp_us;
+        }
+    }
+    
+    for (uint8_t i = 0; i < polyphase->phase_count; i++) {
+        /* An angle needs fresh data on both the phase and the reference */
+        if ((fresh & (1UL << i)) && (fresh & 1UL)) {
+            update_angle(polyphase, i);
+        } else {
+            polyphase->angle_valid &= ~(1UL << i);
+        }
+    }
+    
+    return pc814_polyphase_is_valid(polyphase) ? PC814_OK : PC814_ERROR;
+}
+
+/* Enable event-driven mode */
+pc814_status_t pc814_polyphase_enable_events(pc814_polyphase_t *polyphase)
+{
+    if (polyphase == NULL || !polyphase->initialized) {
+        return PC814_ERROR;
+    }
+    
+    polyphase->phase_seen = 0;
+    polyphase->angle_valid = 0;
+    memset(polyphase->phase_period, 0, sizeof(polyphase->phase_period));
+    polyphase->event_driven = true;
+    
+    for (uint8_t i = 0; i < polyphase->phase_count; i++) {
+        pc814_set_capture_hook(polyphase->phases[i], polyphase_capture_hook, polyphase);
+    }
+    
+    return PC814_OK;
+}
+
+/* Disable event-driven mode */
+void pc814_polyphase_disable_events(pc814_polyphase_t *polyphase)
+{
+    if (polyphase == NULL || !polyphase->initialized) {
+        return;
+    }
+    
+    for (uint8_t i = 0; i < polyphase->phase_count; i++) {
+        pc814_set_capture_hook(polyphase->phases[i], NULL, NULL);
+    }
+    polyphase->event_driven = false;
+}
+
+/* Enable shared-timebase capture */
+pc814_status_t pc814_polyphase_set_shared_timebase(pc814_polyphase_t *polyphase,
+                                                   pc814_timebase_t *timebase)
+{
+    if (polyphase == NULL || !polyphase->initialized || timebase == NULL) {
+        return PC814_ERROR;
+    }
+    
+    polyphase->timebase = timebase;
+    return pc814_polyphase_enable_events(polyphase);
+}
+
+/* Dispatch one channel capture of the shared timer */
+pc814_status_t pc814_polyphase_capture(pc814_polyphase_t *polyphase,
+                                       uint8_t phase,
+                                       uint32_t raw_capture,
+                                       bool overflow_pending)
+{
+    if (polyphase == NULL || !polyphase->initialized || polyphase->timebase == NULL) {
+        return PC814_ERROR;
+    }
+    
+    if (phase >= polyphase->phase_count) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    uint32_t ticks = pc814_timebase_extend(polyphase->timebase, raw_capture, overflow_pending);
+    return pc814_process_capture_value(polyphase->phases[phase], ticks);
+}
+
+/* Set update callback */
+void pc814_polyphase_set_callback(pc814_polyphase_t *polyphase,
+                                  pc814_polyphase_callback_t callback)
+{
+    if (polyphase != NULL) {
+        polyphase->callback = callback;
+    }
+}
+
+/* Check if all angles are valid */
+bool pc814_polyphase_is_valid(pc814_polyphase_t *polyphase)
+{
+    if (polyphase == NULL || !polyphase->initialized) {
+        return false;
+    }
+    
+    uint32_t mask = all_phases(polyphase);
+    return (polyphase->angle_valid & mask) == mask;
+}
+
+/* Get angle between two phases (binary angle) */
+pc814_bam_t pc814_polyphase_get_angle_bam(pc814_polyphase_t *polyphase, uint8_t from, uint8_t to)
+{
+    if (polyphase == NULL || !polyphase->initialized ||
+        from >= polyphase->phase_count || to >= polyphase->phase_count) {
+        return 0;
+    }
+    
+    /* Both angles must be cycle-matched to the reference phase */
+    uint32_t mask = (1UL << from) | (1UL << to);
+    if ((polyphase->angle_valid & mask) != mask) {
+        return 0;
+    }
+    
+    /* Both angles are measured from the reference phase */
+    return (pc814_bam_t)(polyphase->angle[to] - polyphase->angle[from]);
+}
+
+/* Get angle between two phases (degrees) */
+float pc814_polyphase_get_angle(pc814_polyphase_t *polyphase, uint8_t from, uint8_t to)
+{
+    return PC814_BAM_TO_DEG(pc814_polyphase_get_angle_bam(polyphase, from, to));
+}
+
+/* Get full angle matrix */
+pc814_status_t pc814_polyphase_get_angle_matrix(pc814_polyphase_t *polyphase, float *matrix)
+{
+    if (matrix == NULL || !pc814_polyphase_is_valid(polyphase)) {
+        return PC814_ERROR;
+    }
+    
+    uint8_t n = polyphase->phase_count;
+    for (uint8_t i = 0; i < n; i++) {
+        for (uint8_t j = 0; j < n; j++) {
+            matrix[i * n + j] = PC814_BAM_TO_DEG((pc814_bam_t)(polyphase->angle[j] - polyphase->angle[i]));
+        }
+    }
+    
+    return PC814_OK;
+}
+
+/* Detect phase sequence */
+pc814_poly_sequence_t pc814_polyphase_get_sequence(pc814_polyphase_t *polyphase)
+{
+    if (polyphase == NULL || !polyphase->initialized) {
+        return PC814_POLY_SEQUENCE_ERROR;
+    }
+    
+    if ((polyphase->phase_seen & all_phases(polyphase)) != all_phases(polyphase)) {
+        return PC814_POLY_SEQUENCE_UNKNOWN;
+    }
+    
+    if (!pc814_polyphase_is_valid(polyphase)) {
+        return PC814_POLY_SEQUENCE_ERROR;
+    }
+    
+    bool forward = true;
+    bool reverse = true;
+    
+    for (uint8_t i = 1; i < polyphase->phase_count; i++) {
+        pc814_bam_t angle = polyphase->angle[i];
+        
+        if (pc814_bam_distance(angle, polyphase->nominal[i]) > polyphase->tolerance) {
+            forward = false;
+        }
+        if (pc814_bam_distance(angle, (pc814_bam_t)(0U - polyphase->nominal[i])) > polyphase->tolerance) {
+            reverse = false;
+        }
+    }
+    
+    /* Symmetric systems (e.g. split-phase 180°) match both: report forward */
+    if (forward) {
+        return PC814_POLY_SEQUENCE_FORWARD;
+    }
+    if (reverse) {
+        return PC814_POLY_SEQUENCE_REVERSE;
+    }
+    
+    return PC814_POLY_SEQUENCE_ERROR;
+}
+
+/* Get phase imbalance percentage */
+float pc814_polyphase_get_imbalance(pc814_polyphase_t *polyphase)
+{
+    if (!pc814_polyphase_is_valid(polyphase)) {
+        return -1.0f;
+    }
+    
+    bool reverse = (pc814_polyphase_get_sequence(polyphase) == PC814_POLY_SEQUENCE_REVERSE);
+    uint32_t dev_sum = 0;
+    
+    for (uint8_t i = 1; i < polyphase->phase_count; i++) {
+        pc814_bam_t nominal = reverse ? (pc814_bam_t)(0U - polyphase->nominal[i]) : polyphase->nominal[i];
+        dev_sum += pc814_bam_distance(polyphase->angle[i], nominal);
+    }
+    
+    /* Mean deviation as percentage of the phase step (65536 / n) */
+    uint32_t others = polyphase->phase_count - 1U;
+    return ((float)dev_sum * (float)polyphase->phase_count * 100.0f) / ((float)others * 65536.0f);
+}
+
+/* Reset polyphase system */
+void pc814_polyphase_reset(pc814_polyphase_t *polyphase)
+{
+    if (polyphase == NULL) {
+        return;
+    }
+    
+    polyphase->phase_seen = 0;
+    polyphase->angle_valid = 0;
+    memset(polyphase->phase_zc, 0, sizeof(polyphase->phase_zc));
+    memset(polyphase->phase_period, 0, sizeof(polyphase->phase_period));
+    memset(polyphase->angle, 0, sizeof(polyphase->angle));
+}
+
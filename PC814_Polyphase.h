@@ -0,0 +1,217 @@
+/*
+ * PC814_Polyphase.h
+ * 
+ * PC814 Polyphase (N-Phase) System Support
+ * Phase angles and sequence for systems with any number of phases
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Generalization of the three-phase module to an array of
+ *              N PC814 handles (split-phase 180°, two-phase 90°, six-phase
+ *              rectifier transformers, ...). Each phase keeps one binary
+ *              angle to the reference phase; any pair angle is the
+ *              difference of two entries, so an edge costs O(1).
+ *              For plain three-phase systems PC814_ThreePhase remains the
+ *              specialized path (AB/BC/CA fields, swap recommendations).
+ */
+
+#ifndef PC814_POLYPHASE_H
+#define PC814_POLYPHASE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include "PC814_ThreePhase.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum number of phases (bit masks are 32 bits wide) */
+#ifndef PC814_POLYPHASE_MAX_PHASES
+#define PC814_POLYPHASE_MAX_PHASES 12
+#endif
+
+#if PC814_POLYPHASE_MAX_PHASES < 2 || PC814_POLYPHASE_MAX_PHASES > 32
+#error "PC814_POLYPHASE_MAX_PHASES must be 2-32 (phase bit masks are 32 bits wide)"
+#endif
+
+/* Polyphase sequence */
+typedef enum {
+    PC814_POLY_SEQUENCE_FORWARD = 0,   /* Phase k leads by nominal angle k */
+    PC814_POLY_SEQUENCE_REVERSE = 1,   /* Phase k lags by nominal angle k */
+    PC814_POLY_SEQUENCE_UNKNOWN = 2,   /* Not all phases seen yet */
+    PC814_POLY_SEQUENCE_ERROR = 3      /* Angles match neither order */
+} pc814_poly_sequence_t;
+
+/* Polyphase system handle */
+typedef struct pc814_polyphase_s pc814_polyphase_t;
+
+/* Polyphase update callback (event-driven mode, interrupt context) */
+typedef void (*pc814_polyphase_callback_t)(pc814_polyphase_t *polyphase, uint8_t phase);
+
+struct pc814_polyphase_s {
+    pc814_handle_t *phases[PC814_POLYPHASE_MAX_PHASES]; /* Phase handles, [0] is reference */
+    uint8_t phase_count;         /* Number of phases (2 to PC814_POLYPHASE_MAX_PHASES) */
+    uint32_t phase_zc[PC814_POLYPHASE_MAX_PHASES];      /* Last zero-crossing per phase (angle time units) */
+    uint32_t phase_period[PC814_POLYPHASE_MAX_PHASES];  /* Last valid period per phase (angle time units) */
+    pc814_bam_t angle[PC814_POLYPHASE_MAX_PHASES];      /* Angle of phase k after reference phase */
+    pc814_bam_t nominal[PC814_POLYPHASE_MAX_PHASES];    /* Nominal angle of phase k (forward order) */
+    pc814_bam_t tolerance;       /* Sequence tolerance (binary angle) */
+    uint32_t phase_seen;         /* Bit mask of phases with valid data */
+    uint32_t angle_valid;        /* Bit mask of cycle-matched angles */
+    uint32_t last_update_time;   /* Last update timestamp */
+    pc814_timebase_t *timebase;  /* Shared timebase (NULL: angles from get_time_us) */
+    pc814_polyphase_callback_t callback; /* Update callback */
+    bool event_driven;           /* Updated from each phase's capture */
+    bool initialized;            /* Initialization flag */
+};
+
+/**
+ * Initialize polyphase system
+ * Nominal angles default to k * 360 / phase_count (evenly spaced).
+ * @param polyphase Pointer to polyphase handle
+ * @param phases Array of phase handles; phases[0] is the reference phase
+ * @param phase_count Number of phases (2 to PC814_POLYPHASE_MAX_PHASES)
+ * @return PC814_OK on success, PC814_INVALID_PARAM if phase_count is out of range
+ */
+pc814_status_t pc814_polyphase_init(pc814_polyphase_t *polyphase,
+                                    pc814_handle_t *const *phases,
+                                    uint8_t phase_count);
+
+/**
+ * Set nominal angle of one phase after the reference (e.g. 90° for two-phase)
+ * @param polyphase Pointer to polyphase handle
+ * @param phase Phase index (1 to phase_count - 1)
+ * @param angle_deg Nominal angle in degrees (0-360)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_polyphase_set_nominal_angle(pc814_polyphase_t *polyphase,
+                                                 uint8_t phase,
+                                                 float angle_deg);
+
+/**
+ * Set sequence tolerance
+ * @param polyphase Pointer to polyphase handle
+ * @param tolerance Tolerance in degrees (default: 10.0)
+ */
+void pc814_polyphase_set_tolerance(pc814_polyphase_t *polyphase, float tolerance);
+
+/**
+ * Process polyphase system (polled mode, call periodically)
+ * A phase without valid data is skipped and loses its angle; the other
+ * phases are still updated.
+ * @param polyphase Pointer to polyphase handle
+ * @return PC814_OK on success, PC814_ERROR if a phase has no data or is not cycle-matched
+ */
+pc814_status_t pc814_polyphase_process(pc814_polyphase_t *polyphase);
+
+/**
+ * Enable event-driven mode
+ * Each phase's capture updates only its own angle to the reference phase.
+ * Installs the capture hook on all phase handles.
+ * @param polyphase Pointer to polyphase handle
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_polyphase_enable_events(pc814_polyphase_t *polyphase);
+
+/**
+ * Disable event-driven mode (removes capture hooks)
+ * @param polyphase Pointer to polyphase handle
+ */
+void pc814_polyphase_disable_events(pc814_polyphase_t *polyphase);
+
+/**
+ * Enable shared-timebase capture (all phases on channels of one timer)
+ * Enables event-driven mode. Feed captures through pc814_polyphase_capture.
+ * @param polyphase Pointer to polyphase handle
+ * @param timebase Extended timebase of the shared timer
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_polyphase_set_shared_timebase(pc814_polyphase_t *polyphase,
+                                                   pc814_timebase_t *timebase);
+
+/**
+ * Dispatch one channel capture of the shared timer (call from the timer ISR)
+ * @param polyphase Pointer to polyphase handle
+ * @param phase Phase index whose channel captured
+ * @param raw_capture Raw capture register value
+ * @param overflow_pending true if the timer overflow flag is set but not yet counted
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_polyphase_capture(pc814_polyphase_t *polyphase,
+                                       uint8_t phase,
+                                       uint32_t raw_capture,
+                                       bool overflow_pending);
+
+/**
+ * Set update callback (called after each event-driven update)
+ * @param polyphase Pointer to polyphase handle
+ * @param callback Callback function pointer
+ */
+void pc814_polyphase_set_callback(pc814_polyphase_t *polyphase,
+                                  pc814_polyphase_callback_t callback);
+
+/**
+ * Check if every phase has a cycle-matched angle
+ * @param polyphase Pointer to polyphase handle
+ * @return true if all angles are valid
+ */
+bool pc814_polyphase_is_valid(pc814_polyphase_t *polyphase);
+
+/**
+ * Get angle from one phase to another as binary angle
+ * @param polyphase Pointer to polyphase handle
+ * @param from Phase index
+ * @param to Phase index
+ * @return Angle of 'to' after 'from' (65536 = 360°), 0 on error or if
+ *         either phase has no cycle-matched angle
+ */
+pc814_bam_t pc814_polyphase_get_angle_bam(pc814_polyphase_t *polyphase, uint8_t from, uint8_t to);
+
+/**
+ * Get angle from one phase to another
+ * @param polyphase Pointer to polyphase handle
+ * @param from Phase index
+ * @param to Phase index
+ * @return Angle of 'to' after 'from' in degrees (0-360), 0 on error or if
+ *         either phase has no cycle-matched angle
+ */
+float pc814_polyphase_get_angle(pc814_polyphase_t *polyphase, uint8_t from, uint8_t to);
+
+/**
+ * Get full angle matrix
+ * @param polyphase Pointer to polyphase handle
+ * @param matrix Row-major phase_count x phase_count array; matrix[i * n + j] is angle i->j in degrees
+ * @return PC814_OK on success, PC814_ERROR if angles are not valid
+ */
+pc814_status_t pc814_polyphase_get_angle_matrix(pc814_polyphase_t *polyphase, float *matrix);
+
+/**
+ * Detect phase sequence from the current angles
+ * @param polyphase Pointer to polyphase handle
+ * @return FORWARD, REVERSE, UNKNOWN or ERROR
+ */
+pc814_poly_sequence_t pc814_polyphase_get_sequence(pc814_polyphase_t *polyphase);
+
+/**
+ * Get phase imbalance percentage
+ * Mean deviation from the nominal angles as percentage of 360 / phase_count.
+ * @param polyphase Pointer to polyphase handle
+ * @return Imbalance percentage, negative on error
+ */
+float pc814_polyphase_get_imbalance(pc814_polyphase_t *polyphase);
+
+/**
+ * Reset polyphase system (keeps handles and nominal angles)
+ * @param polyphase Pointer to polyphase handle
+ */
+void pc814_polyphase_reset(pc814_polyphase_t *polyphase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_POLYPHASE_H */
+
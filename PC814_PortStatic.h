@@ -0,0 +1,163 @@
+/*
+ * PC814_PortStatic.h
+ * 
+ * PC814 Compile-Time Port Binding
+ * Port functions bound at compile time for inlining in the capture path
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Build PC814.c with PC814_PORT_STATIC_HEADER set to the name of
+ *              a header that defines the port as static inline functions:
+ * 
+ *                  -DPC814_PORT_STATIC_HEADER="\"my_port.h\""
+ * 
+ *              Each function has the pc814_port_v2_t signature and is named
+ *              pc814_port_<member>, e.g.
+ * 
+ *                  #define PC814_PORT_HAS_timer_get_capture_value 1
+ *                  static inline uint32_t pc814_port_timer_get_capture_value(void *ctx)
+ *                  {
+ *                      return ((TIM_TypeDef *)ctx)->CCR1;
+ *                  }
+ * 
+ *              The PC814_PORT_HAS_<member> define marks a function as present.
+ *              Missing functions are treated like NULL members of a port
+ *              table. A constant pc814_port_timer_get_frequency lets the
+ *              compiler fold the tick/microsecond conversions. The ctx
+ *              argument is the context given to pc814_init_v2; the port
+ *              pointers passed to pc814_init / pc814_init_v2 are ignored
+ *              and may be NULL. Include this header only from PC814.c.
+ */
+
+#ifndef PC814_PORTSTATIC_H
+#define PC814_PORTSTATIC_H
+
+#include <stdint.h>
+
+#include PC814_PORT_STATIC_HEADER
+
+/* Functions the port does not provide behave like NULL table members */
+
+#ifndef PC814_PORT_HAS_timer_get_capture_value
+#define PC814_PORT_HAS_timer_get_capture_value 0
+static inline uint32_t pc814_port_timer_get_capture_value(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_get_frequency
+#define PC814_PORT_HAS_timer_get_frequency 0
+static inline uint32_t pc814_port_timer_get_frequency(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_reset_capture
+#define PC814_PORT_HAS_timer_reset_capture 0
+static inline void pc814_port_timer_reset_capture(void *ctx)
+{
+    (void)ctx;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_start_capture
+#define PC814_PORT_HAS_timer_start_capture 0
+static inline void pc814_port_timer_start_capture(void *ctx)
+{
+    (void)ctx;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_stop_capture
+#define PC814_PORT_HAS_timer_stop_capture 0
+static inline void pc814_port_timer_stop_capture(void *ctx)
+{
+    (void)ctx;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_set_compare
+#define PC814_PORT_HAS_timer_set_compare 0
+static inline void pc814_port_timer_set_compare(void *ctx, uint32_t compare_value)
+{
+    (void)ctx;
+    (void)compare_value;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_disable_compare
+#define PC814_PORT_HAS_timer_disable_compare 0
+static inline void pc814_port_timer_disable_compare(void *ctx)
+{
+    (void)ctx;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_gpio_set_pull_up
+#define PC814_PORT_HAS_gpio_set_pull_up 0
+static inline void pc814_port_gpio_set_pull_up(void *ctx)
+{
+    (void)ctx;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_gpio_set_pull_down
+#define PC814_PORT_HAS_gpio_set_pull_down 0
+static inline void pc814_port_gpio_set_pull_down(void *ctx)
+{
+    (void)ctx;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_get_time_us
+#define PC814_PORT_HAS_get_time_us 0
+static inline uint32_t pc814_port_get_time_us(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_delay_us
+#define PC814_PORT_HAS_delay_us 0
+static inline void pc814_port_delay_us(void *ctx, uint32_t us)
+{
+    (void)ctx;
+    (void)us;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_delay_ms
+#define PC814_PORT_HAS_delay_ms 0
+static inline void pc814_port_delay_ms(void *ctx, uint32_t ms)
+{
+    (void)ctx;
+    (void)ms;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_timer_get_counter
+#define PC814_PORT_HAS_timer_get_counter 0
+static inline uint32_t pc814_port_timer_get_counter(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+#endif
+
+#ifndef PC814_PORT_HAS_get_cycles
+#define PC814_PORT_HAS_get_cycles 0
+static inline uint32_t pc814_port_get_cycles(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+#endif
+
+#endif /* PC814_PORTSTATIC_H */
+
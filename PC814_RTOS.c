@@ -0,0 +1,119 @@
+/*
+ * PC814_RTOS.c
+ * 
+ * PC814 RTOS Integration Implementation
+ * Zero-crossing and line events published from the ISR to a task queue
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Callback trampolines that copy events into the OS queue
+ */
+
+#include "PC814_RTOS.h"
+#include <string.h>
+
+/* Copy one event into the queue (interrupt context) */
+static void publish(pc814_handle_t *handle, pc814_rtos_event_type_t type, pc814_event_t line_event)
+{
+    pc814_rtos_publisher_t *publisher = (pc814_rtos_publisher_t *)pc814_get_user_context(handle);
+    pc814_rtos_event_t event;
+    
+    if (publisher == NULL || !publisher->initialized) {
+        return;
+    }
+    
+    event.handle = handle;
+    event.type = type;
+    event.line_event = line_event;
+    event.data = handle->data;
+    
+    bool sent = pc814_os_queue_send_from_isr(&publisher->queue, &event);
+    
+    /* Handles on interrupts of different priority share the counters */
+    uint32_t state = pc814_os_critical_enter();
+    if (sent) {
+        publisher->published++;
+    } else {
+        publisher->dropped++;
+    }
+    pc814_os_critical_exit(state);
+}
+
+/* Zero-crossing callback installed on attached handles */
+static void publish_crossing(pc814_handle_t *handle, pc814_data_t *data)
+{
+    (void)data;
+    publish(handle, PC814_RTOS_EVENT_CROSSING, PC814_EVENT_NONE);
+}
+
+/* Line event callback installed on attached handles */
+static void publish_line_event(pc814_handle_t *handle, pc814_event_t event)
+{
+    publish(handle, PC814_RTOS_EVENT_LINE, event);
+}
+
+/* Initialize publisher */
+pc814_status_t pc814_rtos_publisher_init(pc814_rtos_publisher_t *publisher,
+                                         pc814_rtos_event_t *buffer, uint32_t depth)
+{
+    if (publisher == NULL || buffer == NULL || depth == 0) {
+        return PC814_ERROR;
+    }
+    
+    memset(publisher, 0, sizeof(pc814_rtos_publisher_t));
+    if (pc814_os_queue_create(&publisher->queue, buffer, sizeof(pc814_rtos_event_t), depth) != PC814_OK) {
+        return PC814_ERROR;
+    }
+    publisher->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Publish handle events */
+pc814_status_t pc814_rtos_attach(pc814_rtos_publisher_t *publisher, pc814_handle_t *handle)
+{
+    if (publisher == NULL || !publisher->initialized || handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    /* Context first: callbacks may fire as soon as they are installed */
+    pc814_set_user_context(handle, publisher);
+    pc814_set_callback(handle, publish_crossing);
+    pc814_set_event_callback(handle, publish_line_event);
+    
+    return PC814_OK;
+}
+
+/* Stop publishing handle events */
+void pc814_rtos_detach(pc814_handle_t *handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    
+    pc814_set_callback(handle, NULL);
+    pc814_set_event_callback(handle, NULL);
+    pc814_set_user_context(handle, NULL);
+}
+
+/* Wait for next event */
+pc814_status_t pc814_rtos_wait_event(pc814_rtos_publisher_t *publisher,
+                                     pc814_rtos_event_t *event, uint32_t timeout_ms)
+{
+    if (publisher == NULL || !publisher->initialized || event == NULL) {
+        return PC814_ERROR;
+    }
+    
+    return pc814_os_queue_receive(&publisher->queue, event, timeout_ms);
+}
+
+/* Get dropped event count */
+uint32_t pc814_rtos_get_dropped(pc814_rtos_publisher_t *publisher)
+{
+    if (publisher == NULL) {
+        return 0;
+    }
+    return publisher->dropped;
+}
+
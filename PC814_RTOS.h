@@ -0,0 +1,99 @@
+/*
+ * PC814_RTOS.h
+ * 
+ * PC814 RTOS Integration
+ * Zero-crossing and line events published from the ISR to a task queue
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Attaching a handle routes its zero-crossing callback and
+ *              line event callback into a queue. The interrupt only copies
+ *              one event; application work (logging, control) runs in a
+ *              task that waits on the queue. A full queue drops the event
+ *              and counts it, so the ISR never blocks.
+ *              Requires PC814_OS.h with a backend selected.
+ */
+
+#ifndef PC814_RTOS_H
+#define PC814_RTOS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include "PC814_OS.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Queued event type */
+typedef enum {
+    PC814_RTOS_EVENT_CROSSING = 0, /* Valid zero-crossing, data is the new measurement */
+    PC814_RTOS_EVENT_LINE = 1      /* Line event (watchdog, auto-range), see line_event */
+} pc814_rtos_event_type_t;
+
+/* Queued event */
+typedef struct {
+    pc814_handle_t *handle;      /* Source handle */
+    pc814_rtos_event_type_t type; /* Event type */
+    pc814_event_t line_event;    /* Line event (PC814_EVENT_NONE for a crossing) */
+    pc814_data_t data;           /* Handle data when the event was raised */
+} pc814_rtos_event_t;
+
+/* Event publisher */
+typedef struct {
+    pc814_os_queue_t queue;      /* Event queue */
+    uint32_t published;          /* Events queued */
+    uint32_t dropped;            /* Events lost on a full queue */
+    bool initialized;            /* Initialization flag */
+} pc814_rtos_publisher_t;
+
+/**
+ * Initialize publisher over caller storage
+ * @param publisher Pointer to publisher
+ * @param buffer Event storage
+ * @param depth Number of events in buffer (bounds the latency of the consumer task)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_rtos_publisher_init(pc814_rtos_publisher_t *publisher,
+                                         pc814_rtos_event_t *buffer, uint32_t depth);
+
+/**
+ * Publish a handle's events through the queue
+ * Uses the handle's zero-crossing callback, event callback and user context.
+ * @param publisher Pointer to publisher
+ * @param handle Pointer to handle
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_rtos_attach(pc814_rtos_publisher_t *publisher, pc814_handle_t *handle);
+
+/**
+ * Stop publishing a handle's events
+ * @param handle Pointer to handle
+ */
+void pc814_rtos_detach(pc814_handle_t *handle);
+
+/**
+ * Wait for the next event (task context)
+ * @param publisher Pointer to publisher
+ * @param event Pointer to event to fill
+ * @param timeout_ms Maximum wait (0 = poll, PC814_OS_WAIT_FOREVER = no limit)
+ * @return PC814_OK if an event was received, PC814_ERROR on timeout
+ */
+pc814_status_t pc814_rtos_wait_event(pc814_rtos_publisher_t *publisher,
+                                     pc814_rtos_event_t *event, uint32_t timeout_ms);
+
+/**
+ * Get number of events dropped on a full queue
+ * @param publisher Pointer to publisher
+ * @return Dropped events
+ */
+uint32_t pc814_rtos_get_dropped(pc814_rtos_publisher_t *publisher);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_RTOS_H */
+
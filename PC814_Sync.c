@@ -0,0 +1,250 @@
+/*
+ * PC814_Sync.c
+ * 
+ * PC814 Synchroscope / Sync-Check Implementation
+ * Phase difference, slip frequency and breaker-close window between two sources
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Integer phase and slip math, float only in the result
+ */
+
+#include "PC814_Sync.h"
+#include <string.h>
+
+/* Default close limits */
+#define PC814_SYNC_DEFAULT_MAX_SLIP_MHZ  200
+#define PC814_SYNC_DEFAULT_MAX_ANGLE     10.0f
+
+/* Running source is stale after one period plus this percentage */
+#ifndef PC814_SYNC_STALE_MARGIN
+#define PC814_SYNC_STALE_MARGIN          25
+#endif
+
+/* No running edge for longer than one period plus margin */
+static bool running_stale(pc814_sync_t *sync, uint32_t zc_us, uint32_t period_us)
+{
+    uint32_t now;
+    
+    if (period_us == 0 || pc814_get_port_time_us(sync->running, &now) != PC814_OK) {
+        return false;
+    }
+    
+    return (now - zc_us) > period_us + (period_us * PC814_SYNC_STALE_MARGIN) / 100U;
+}
+
+/* Drop result and close permit */
+static void sync_invalidate(pc814_sync_t *sync)
+{
+    sync->status.valid = false;
+    sync->status.close_permitted = false;
+    sync->have_last = false;
+}
+
+/* Slip in mHz from phase change (binary angle) over dt_us */
+static int32_t slip_from_drift(int16_t dphase, uint32_t dt_us)
+{
+    if (dt_us == 0) {
+        return 0;
+    }
+    
+    /* cycles = dphase / 65536, mHz = cycles * 1e9 / dt_us */
+    return (int32_t)(((int64_t)dphase * 1000000000LL) / ((int64_t)65536 * dt_us));
+}
+
+/* Slip in mHz from the two periods (first update only) */
+static int32_t slip_from_periods(uint32_t running_us, uint32_t reference_us)
+{
+    if (running_us == 0 || reference_us == 0) {
+        return 0;
+    }
+    
+    /* 1e9 / T in mHz */
+    return (int32_t)(1000000000LL / running_us) - (int32_t)(1000000000LL / reference_us);
+}
+
+/* Time for the lead to reach 0 at the given slip (ms) */
+static uint32_t time_to_in_phase(int16_t lead, int32_t slip_mhz)
+{
+    uint32_t remaining;
+    
+    if (slip_mhz == 0) {
+        return (lead == 0) ? 0 : PC814_SYNC_NO_SLIP;
+    }
+    
+    /* Lead grows with positive slip: next zero is +360 away unless behind */
+    if (slip_mhz > 0) {
+        remaining = (lead <= 0) ? (uint32_t)(-(int32_t)lead) : (uint32_t)(65536 - (int32_t)lead);
+    } else {
+        remaining = (lead >= 0) ? (uint32_t)lead : (uint32_t)(65536 + (int32_t)lead);
+    }
+    
+    uint32_t slip = (uint32_t)((slip_mhz < 0) ? -slip_mhz : slip_mhz);
+    
+    /* remaining / 65536 cycles at slip / 1000 cycles per second */
+    return (uint32_t)(((uint64_t)remaining * 1000000ULL) / ((uint64_t)65536 * slip));
+}
+
+/* Initialize sync-check */
+pc814_status_t pc814_sync_init(pc814_sync_t *sync,
+                               pc814_handle_t *running,
+                               pc814_handle_t *reference)
+{
+    if (sync == NULL || running == NULL || reference == NULL || running == reference) {
+        return PC814_ERROR;
+    }
+    
+    memset(sync, 0, sizeof(pc814_sync_t));
+    sync->running = running;
+    sync->reference = reference;
+    sync->max_slip_mhz = PC814_SYNC_DEFAULT_MAX_SLIP_MHZ;
+    sync->max_angle = PC814_BAM_FROM_DEG(PC814_SYNC_DEFAULT_MAX_ANGLE);
+    sync->status.time_to_in_phase_ms = PC814_SYNC_NO_SLIP;
+    sync->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Initialize sync-check between two three-phase systems */
+pc814_status_t pc814_sync_init_threephase(pc814_sync_t *sync,
+                                          pc814_threephase_t *running,
+                                          pc814_threephase_t *reference)
+{
+    if (running == NULL || reference == NULL) {
+        return PC814_ERROR;
+    }
+    
+    return pc814_sync_init(sync, running->phase_a, reference->phase_a);
+}
+
+/* Set breaker closing time */
+void pc814_sync_set_breaker_time(pc814_sync_t *sync, uint32_t close_time_ms)
+{
+    if (sync != NULL) {
+        sync->breaker_close_us = close_time_ms * 1000U;
+    }
+}
+
+/* Set close permission limits */
+pc814_status_t pc814_sync_set_limits(pc814_sync_t *sync, uint32_t max_slip_mhz, float max_angle_deg)
+{
+    if (sync == NULL || !sync->initialized) {
+        return PC814_ERROR;
+    }
+    
+    if (max_angle_deg < 0.0f || max_angle_deg > 90.0f) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    sync->max_slip_mhz = max_slip_mhz;
+    sync->max_angle = PC814_BAM_FROM_DEG(max_angle_deg);
+    return PC814_OK;
+}
+
+/* Update synchroscope */
+pc814_status_t pc814_sync_update(pc814_sync_t *sync)
+{
+    if (sync == NULL || !sync->initialized) {
+        return PC814_ERROR;
+    }
+    
+    pc814_data_t run, ref;
+    pc814_sync_status_t *status = &sync->status;
+    
+    if (pc814_read_data(sync->running, &run) != PC814_OK || !run.valid ||
+        pc814_read_data(sync->reference, &ref) != PC814_OK || !ref.valid ||
+        running_stale(sync, run.timestamp_us, run.period_us)) {
+        sync_invalidate(sync);
+        return PC814_ERROR;
+    }
+    
+    /* Once per running-source cycle */
+    if (run.count == sync->last_count && status->valid) {
+        return PC814_OK;
+    }
+    sync->last_count = run.count;
+    
+    /* Nearest reference edge only */
+    int32_t diff = (int32_t)(run.timestamp_us - ref.timestamp_us);
+    int32_t limit = (int32_t)(ref.period_us + ref.period_us / 2);
+    if (diff > limit || diff < -limit) {
+        sync_invalidate(sync);
+        return PC814_ERROR;
+    }
+    
+    /* Running edge after reference edge means it lags: lead is the negative */
+    pc814_bam_t lag = pc814_bam_phase_angle(ref.timestamp_us, run.timestamp_us, ref.period_us);
+    int16_t lead = (int16_t)(uint16_t)(0U - lag);
+    
+    int32_t slip;
+    if (sync->have_last) {
+        slip = slip_from_drift((int16_t)(uint16_t)((uint16_t)lead - (uint16_t)sync->last_phase),
+                               run.timestamp_us - sync->last_zc_us);
+    } else {
+        slip = slip_from_periods(run.period_us, ref.period_us);
+    }
+    
+    sync->last_phase = lead;
+    sync->last_zc_us = run.timestamp_us;
+    sync->last_period_us = run.period_us;
+    sync->have_last = true;
+    
+    /* Phase at breaker contact: lead advances 65536 per cycle of slip */
+    int64_t advance = ((int64_t)slip * 65536 * (int64_t)sync->breaker_close_us) / 1000000000LL;
+    int16_t at_close = (int16_t)(uint16_t)((uint16_t)lead + (uint16_t)(uint64_t)advance);
+    uint32_t abs_slip = (uint32_t)((slip < 0) ? -slip : slip);
+    uint32_t abs_close = (uint32_t)((at_close < 0) ? -(int32_t)at_close : at_close);
+    
+    status->phase_deg = (float)lead * (360.0f / 65536.0f);
+    status->slip_mhz = slip;
+    status->time_to_in_phase_ms = time_to_in_phase(lead, slip);
+    status->close_angle_deg = (float)at_close * (360.0f / 65536.0f);
+    status->close_permitted = (abs_slip <= sync->max_slip_mhz) && (abs_close <= sync->max_angle);
+    status->valid = true;
+    
+    return PC814_OK;
+}
+
+/* Get last synchroscope result */
+pc814_status_t pc814_sync_get_status(pc814_sync_t *sync, pc814_sync_status_t *status)
+{
+    if (sync == NULL || status == NULL) {
+        return PC814_ERROR;
+    }
+    
+    memcpy(status, &sync->status, sizeof(pc814_sync_status_t));
+    return status->valid ? PC814_OK : PC814_ERROR;
+}
+
+/* Check if breaker close is permitted */
+bool pc814_sync_close_permitted(pc814_sync_t *sync)
+{
+    if (sync == NULL || !sync->initialized) {
+        return false;
+    }
+    if (!sync->status.valid || !sync->status.close_permitted) {
+        return false;
+    }
+    
+    /* Never hand out a permit latched before the running source stopped */
+    if (running_stale(sync, sync->last_zc_us, sync->last_period_us)) {
+        sync_invalidate(sync);
+        return false;
+    }
+    return true;
+}
+
+/* Reset slip measurement */
+void pc814_sync_reset(pc814_sync_t *sync)
+{
+    if (sync == NULL) {
+        return;
+    }
+    
+    sync->have_last = false;
+    sync->last_count = 0;
+    memset(&sync->status, 0, sizeof(pc814_sync_status_t));
+    sync->status.time_to_in_phase_ms = PC814_SYNC_NO_SLIP;
+}
+
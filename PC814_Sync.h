@@ -0,0 +1,136 @@
+/*
+ * PC814_Sync.h
+ * 
+ * PC814 Synchroscope / Sync-Check
+ * Phase difference, slip frequency and breaker-close window between two sources
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Compares the zero-crossings of a running (incoming) source,
+ *              e.g. a generator, against a reference source, e.g. the grid
+ *              bus. Reports phase difference and slip every cycle, predicts
+ *              the time to in-phase and permits breaker close only when the
+ *              phase at contact time (after the breaker closing delay) is
+ *              inside the angle window.
+ */
+
+#ifndef PC814_SYNC_H
+#define PC814_SYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include "PC814_ThreePhase.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Time to in-phase when the sources do not slip */
+#define PC814_SYNC_NO_SLIP 0xFFFFFFFFUL
+
+/* Synchroscope result */
+typedef struct {
+    float phase_deg;             /* Running source lead over reference (-180 to +180) */
+    int32_t slip_mhz;            /* Running minus reference frequency (mHz) */
+    uint32_t time_to_in_phase_ms; /* Time until phase difference reaches 0 (PC814_SYNC_NO_SLIP if none) */
+    float close_angle_deg;       /* Predicted phase difference at breaker contact */
+    bool close_permitted;        /* Slip and predicted angle inside limits */
+    bool valid;                  /* Both sources valid and cycle-matched */
+} pc814_sync_status_t;
+
+/* Sync-check handle */
+typedef struct {
+    pc814_handle_t *running;     /* Incoming source (generator) */
+    pc814_handle_t *reference;   /* Reference source (bus / grid) */
+    uint32_t last_count;         /* Running source count at last update */
+    uint32_t last_zc_us;         /* Running source zero-crossing at last update */
+    uint32_t last_period_us;     /* Running source period at last update */
+    int16_t last_phase;          /* Lead at last update (binary angle, signed) */
+    bool have_last;              /* last_* fields are valid */
+    uint32_t breaker_close_us;   /* Breaker closing time */
+    uint32_t max_slip_mhz;       /* Maximum slip for close */
+    pc814_bam_t max_angle;       /* Maximum predicted angle for close */
+    pc814_sync_status_t status;  /* Last result */
+    bool initialized;            /* Initialization flag */
+} pc814_sync_t;
+
+/**
+ * Initialize sync-check between two sources
+ * @param sync Pointer to sync handle
+ * @param running Incoming source (e.g. generator)
+ * @param reference Reference source (e.g. bus)
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_sync_init(pc814_sync_t *sync,
+                               pc814_handle_t *running,
+                               pc814_handle_t *reference);
+
+/**
+ * Initialize sync-check between two three-phase systems (compares phase A)
+ * @param sync Pointer to sync handle
+ * @param running Incoming three-phase system
+ * @param reference Reference three-phase system
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_sync_init_threephase(pc814_sync_t *sync,
+                                          pc814_threephase_t *running,
+                                          pc814_threephase_t *reference);
+
+/**
+ * Set breaker closing time (command to contact)
+ * @param sync Pointer to sync handle
+ * @param close_time_ms Closing time in milliseconds (default 0)
+ */
+void pc814_sync_set_breaker_time(pc814_sync_t *sync, uint32_t close_time_ms);
+
+/**
+ * Set close permission limits
+ * @param sync Pointer to sync handle
+ * @param max_slip_mhz Maximum slip in mHz (default 200)
+ * @param max_angle_deg Maximum phase difference at contact in degrees (default 10)
+ * @return PC814_OK on success, PC814_INVALID_PARAM if max_angle_deg is outside 0-90
+ */
+pc814_status_t pc814_sync_set_limits(pc814_sync_t *sync, uint32_t max_slip_mhz, float max_angle_deg);
+
+/**
+ * Update synchroscope (call at least once per cycle)
+ * Recomputes only when the running source has a new zero-crossing.
+ * Slip is measured from the phase drift between updates, so updates must
+ * not skip so many cycles that the phase moves more than 180°.
+ * The result and close permit are dropped when the running source has had
+ * no edge for one period plus PC814_SYNC_STALE_MARGIN (needs get_time_us).
+ * @param sync Pointer to sync handle
+ * @return PC814_OK on success, PC814_ERROR if a source has no valid data
+ */
+pc814_status_t pc814_sync_update(pc814_sync_t *sync);
+
+/**
+ * Get last synchroscope result
+ * @param sync Pointer to sync handle
+ * @param status Pointer to status structure to fill
+ * @return PC814_OK if the result is valid
+ */
+pc814_status_t pc814_sync_get_status(pc814_sync_t *sync, pc814_sync_status_t *status);
+
+/**
+ * Check if breaker close is permitted now
+ * Also false once the running source has gone silent since the last update.
+ * @param sync Pointer to sync handle
+ * @return true if the close command may be issued
+ */
+bool pc814_sync_close_permitted(pc814_sync_t *sync);
+
+/**
+ * Reset slip measurement (e.g. after switching sources)
+ * @param sync Pointer to sync handle
+ */
+void pc814_sync_reset(pc814_sync_t *sync);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_SYNC_H */
+
@@ -18,69 +18,506 @@
 /* Default tolerance for sequence detection (degrees) */
 #define PC814_DEFAULT_SEQUENCE_TOLERANCE 10.0f
 
+/* Default phase-loss timeout margin (percent of period beyond one period) */
+#define PC814_DEFAULT_LOSS_MARGIN 25
+
 /* Expected phase angle for correct sequence (degrees) */
 #define PC814_EXPECTED_PHASE_ANGLE 120.0f
 
+/* Internal angle type: binary angle or float degrees */
+#ifdef PC814_THREEPHASE_FIXED_POINT
+typedef pc814_bam_t angle_t;
+#define ANGLE_120      PC814_BAM_120
+#define ANGLE_240      PC814_BAM_240
+#define ANGLE_TO_DEG(a) PC814_BAM_TO_DEG(a)
+#define ANGLE_TO_BAM(a) (a)
+#else
+typedef float angle_t;
+#define ANGLE_120      120.0f
+#define ANGLE_240      240.0f
+#define ANGLE_TO_DEG(a) (a)
+#define ANGLE_TO_BAM(a) PC814_BAM_FROM_DEG(a)
+#endif
+
+/* Quarter-wave sine table, 64 steps, Q14 */
+static const int16_t sine_table[65] = {
+        0,   402,   804,  1205,  1606,  2006,  2404,  2801,
+     3196,  3590,  3981,  4370,  4756,  5139,  5520,  5897,
+     6270,  6639,  7005,  7366,  7723,  8076,  8423,  8765,
+     9102,  9434,  9760, 10080, 10394, 10702, 11003, 11297,
+    11585, 11866, 12140, 12406, 12665, 12916, 13160, 13395,
+    13623, 13842, 14053, 14256, 14449, 14635, 14811, 14978,
+    15137, 15286, 15426, 15557, 15679, 15791, 15893, 15986,
+    16069, 16143, 16207, 16261, 16305, 16340, 16364, 16379,
+    16384
+};
+
+/* Sine of first-quadrant position (0-16384 = 0-90 degrees), Q14 */
+static int32_t sine_quarter(uint32_t position)
+{
+    uint32_t index = position >> 8;
+    int32_t frac = (int32_t)(position & 0xFF);
+    
+    if (index >= 64) {
+        return sine_table[64];
+    }
+    
+    return sine_table[index] + (((sine_table[index + 1] - sine_table[index]) * frac) >> 8);
+}
+
+/* Sine of binary angle (65536 = 360 degrees), Q14 */
+static int32_t sine_q14(uint16_t angle)
+{
+    uint32_t position = angle & 0x3FFF;
+    
+    switch (angle >> 14) {
+        case 0:
+            return sine_quarter(position);
+        case 1:
+            return sine_quarter(0x4000 - position);
+        case 2:
+            return -sine_quarter(position);
+        default:
+            return -sine_quarter(0x4000 - position);
+    }
+}
+
+/* Binary angle of time2 after time1 within one period */
+pc814_bam_t pc814_bam_phase_angle(uint32_t time1, uint32_t time2, uint32_t period)
+{
+    if (period == 0) {
+        return 0;
+    }
+    
+    /* Signed difference: time2 may be older than time1 */
+    int32_t signed_diff = (int32_t)(time2 - time1) % (int32_t)period;
+    if (signed_diff < 0) {
+        signed_diff += (int32_t)period;
+    }
+    
+    uint32_t time_diff = (uint32_t)signed_diff;
+    
+    /* Scale both down until (time_diff << 16) fits in 32 bits */
+    while (period > 0xFFFFUL) {
+        period >>= 1;
+        time_diff >>= 1;
+    }
+    
+    /* time_diff < period, so the quotient is already 0-65535 */
+    return (pc814_bam_t)((time_diff << 16) / period);
+}
+
+/* Absolute distance between two binary angles, shortest way round */
+pc814_bam_t pc814_bam_distance(pc814_bam_t angle, pc814_bam_t nominal)
+{
+    int16_t diff = (int16_t)(uint16_t)(angle - nominal);
+    
+    return (pc814_bam_t)((diff < 0) ? -(int32_t)diff : diff);
+}
+
+/* Add one angle sample to circular-mean accumulator, latch when window is full */
+static void average_add(pc814_angle_average_t *avg, pc814_bam_t angle, uint16_t window)
+{
+    avg->sum_cos += sine_q14((uint16_t)(angle + 0x4000));
+    avg->sum_sin += sine_q14(angle);
+    avg->count++;
+    
+    if (avg->count < window) {
+        return;
+    }
+    
+    /* Latch the window; statistics are derived outside the ISR */
+    avg->window_cos = avg->sum_cos;
+    avg->window_sin = avg->sum_sin;
+    avg->window_count = avg->count;
+    
+    avg->sum_cos = 0;
+    avg->sum_sin = 0;
+    avg->count = 0;
+}
+
 /* Calculate phase angle between two timestamps */
-static float calculate_phase_angle(uint32_t time1, uint32_t time2, uint32_t period_us)
+static angle_t calculate_phase_angle(uint32_t time1, uint32_t time2, uint32_t period_us)
 {
+#ifdef PC814_THREEPHASE_FIXED_POINT
+    return pc814_bam_phase_angle(time1, time2, period_us);
+#else
     if (period_us == 0) {
         return 0.0f;
     }
     
-    uint32_t time_diff;
-    
-    /* Calculate time difference, handling wrap-around */
-    if (time2 >= time1) {
-        time_diff = time2 - time1;
-    } else {
-        /* Handle wrap-around (assuming 32-bit timestamp) */
-        time_diff = (0xFFFFFFFF - time1) + time2 + 1;
+    /* Signed time difference: unsigned subtraction handles wrap-around and
+       time2 may be older than time1 when phases update independently */
+    int32_t signed_diff = (int32_t)(time2 - time1) % (int32_t)period_us;
+    if (signed_diff < 0) {
+        signed_diff += (int32_t)period_us;
     }
     
     /* Normalize to period (handle multiple periods) */
-    time_diff = time_diff % period_us;
+    uint32_t time_diff = (uint32_t)signed_diff;
     
-    /* Calculate angle: (time_diff / period) * 360 */
-    float angle = ((float)time_diff / (float)period_us) * 360.0f;
+    /* Calculate angle: (time_diff / period) * 360, time_diff < period */
+    return ((float)time_diff / (float)period_us) * 360.0f;
+#endif
+}
+
+/* Absolute distance between two angles, shortest way round */
+static angle_t angle_distance(angle_t angle, angle_t nominal)
+{
+#ifdef PC814_THREEPHASE_FIXED_POINT
+    return pc814_bam_distance(angle, nominal);
+#else
+    float diff = angle - nominal;
     
-    /* Normalize to 0-360 range */
-    if (angle >= 360.0f) {
-        angle = fmodf(angle, 360.0f);
+    if (diff < 0.0f) {
+        diff = -diff;
     }
-    if (angle < 0.0f) {
-        angle += 360.0f;
+    if (diff > 180.0f) {
+        diff = 360.0f - diff;
     }
     
-    return angle;
+    return diff;
+#endif
 }
 
-/* Check if angle is approximately 120 degrees */
-static bool is_angle_120(float angle, float tolerance)
+/* Check if angle is approximately 120 degrees (forward sequence) */
+static bool is_angle_120(angle_t angle, angle_t tolerance)
 {
-    float diff_120 = fabsf(angle - 120.0f);
+    return angle_distance(angle, ANGLE_120) <= tolerance;
+}
+
+/* Check if angle is approximately 240 degrees (reverse sequence) */
+static bool is_angle_240(angle_t angle, angle_t tolerance)
+{
+    /* For reverse sequence, we expect ~240 degrees, not 120 */
+    return (angle_distance(angle, ANGLE_240) <= tolerance) &&
+           (angle_distance(angle, ANGLE_120) > tolerance);
+}
+
+/* Sequence tolerance in internal angle units */
+static angle_t angle_tolerance(const pc814_threephase_t *threephase)
+{
+#ifdef PC814_THREEPHASE_FIXED_POINT
+    return threephase->sequence_tolerance_bam;
+#else
+    return threephase->sequence_tolerance;
+#endif
+}
+
+/* Angle from phase to the next phase: A->B, B->C, C->A */
+static angle_t angle_get(const pc814_phase_relationship_t *rel, uint32_t from)
+{
+#ifdef PC814_THREEPHASE_FIXED_POINT
+    switch (from) {
+        case PC814_PHASE_A:
+            return rel->phase_ab_bam;
+        case PC814_PHASE_B:
+            return rel->phase_bc_bam;
+        default:
+            return rel->phase_ca_bam;
+    }
+#else
+    switch (from) {
+        case PC814_PHASE_A:
+            return rel->phase_ab_angle;
+        case PC814_PHASE_B:
+            return rel->phase_bc_angle;
+        default:
+            return rel->phase_ca_angle;
+    }
+#endif
+}
+
+/* Store angle from phase to the next phase (float fields only in float builds) */
+static void angle_set(pc814_phase_relationship_t *rel, uint32_t from, angle_t angle)
+{
+    pc814_bam_t bam = ANGLE_TO_BAM(angle);
     
-    /* Also check 240 degrees (which is -120 in three-phase) */
-    float diff_240 = fabsf(angle - 240.0f);
-    if (diff_240 > 180.0f) {
-        diff_240 = 360.0f - diff_240;
+    switch (from) {
+        case PC814_PHASE_A:
+            rel->phase_ab_bam = bam;
+#ifndef PC814_THREEPHASE_FIXED_POINT
+            rel->phase_ab_angle = angle;
+#endif
+            break;
+        case PC814_PHASE_B:
+            rel->phase_bc_bam = bam;
+#ifndef PC814_THREEPHASE_FIXED_POINT
+            rel->phase_bc_angle = angle;
+#endif
+            break;
+        default:
+            rel->phase_ca_bam = bam;
+#ifndef PC814_THREEPHASE_FIXED_POINT
+            rel->phase_ca_angle = angle;
+#endif
+            break;
+    }
+}
+
+/* Cycle-matched angle from phase to the next phase, against the reference
+   (from) phase's own period. The other phase's edge must be the nearest
+   corresponding edge; a stalled or cycle-slipped phase is rejected. */
+static bool update_angle(pc814_threephase_t *threephase, uint32_t from)
+{
+    uint32_t to = (from + 1) % 3;
+    uint32_t period = threephase->phase_period[from];
+    
+    if (period == 0 || (threephase->phase_lost & ((1U << from) | (1U << to)))) {
+        return false;
+    }
+    
+    int32_t diff = (int32_t)(threephase->phase_zc[to] - threephase->phase_zc[from]);
+    int32_t limit = (int32_t)(period + period / 2);
+    if (diff > limit || diff < -limit) {
+        return false;
     }
     
-    return (diff_120 <= tolerance) || (diff_240 <= tolerance);
+    angle_t angle = calculate_phase_angle(threephase->phase_zc[from], threephase->phase_zc[to], period);
+    angle_set(&threephase->relationship, from, angle);
+    
+    /* One averaging sample per reference-phase cycle, however often we are called */
+    pc814_angle_average_t *avg = &threephase->average[from];
+    if (threephase->average_window > 0 && avg->last_zc != threephase->phase_zc[from]) {
+        avg->last_zc = threephase->phase_zc[from];
+        average_add(avg, ANGLE_TO_BAM(angle), threephase->average_window);
+    }
+    
+    return true;
 }
 
-/* Check if angle is approximately 240 degrees (reverse sequence) */
-static bool is_angle_240(float angle, float tolerance)
+/* Feed one sequence decision into the debounce state machine */
+static void sequence_vote(pc814_threephase_t *threephase, pc814_sequence_t decision)
 {
-    float diff_240 = fabsf(angle - 240.0f);
-    if (diff_240 > 180.0f) {
-        diff_240 = 360.0f - diff_240;
+    bool agree = (decision == threephase->sequence);
+    
+    threephase->raw_sequence = decision;
+    threephase->agree_history = (uint16_t)((threephase->agree_history << 1) | (agree ? 1U : 0U));
+    if (threephase->history_len < 16) {
+        threephase->history_len++;
     }
     
-    float diff_120 = fabsf(angle - 120.0f);
+    if (agree) {
+        threephase->candidate_votes = 0;
+        return;
+    }
     
-    /* For reverse sequence, we expect ~240 degrees, not 120 */
-    return (diff_240 <= tolerance) && (diff_120 > tolerance);
+    if (decision != threephase->candidate) {
+        threephase->candidate = decision;
+        threephase->candidate_votes = 0;
+    }
+    
+    threephase->candidate_votes++;
+    if (threephase->candidate_votes < threephase->sequence_votes) {
+        return;
+    }
+    
+    /* Confirmed: the last 'votes' decisions all agree with the new state */
+    pc814_sequence_t old_sequence = threephase->sequence;
+    threephase->sequence = decision;
+    threephase->candidate_votes = 0;
+    threephase->agree_history = (uint16_t)((1UL << threephase->sequence_votes) - 1UL);
+    threephase->history_len = threephase->sequence_votes;
+    
+    if (threephase->sequence_callback != NULL) {
+        threephase->sequence_callback(threephase, old_sequence, decision);
+    }
+    pc814_bus_publish(threephase->phase_a, PC814_BUS_SEQUENCE_CHANGE);
+}
+
+/* Mark phase lost or restored, report transitions */
+static void set_phase_lost(pc814_threephase_t *threephase, uint32_t phase, bool lost)
+{
+    uint8_t bit = (uint8_t)(1U << phase);
+    
+    if (lost == ((threephase->phase_lost & bit) != 0)) {
+        return;
+    }
+    
+    if (lost) {
+        threephase->phase_lost |= bit;
+    } else {
+        threephase->phase_lost &= (uint8_t)~bit;
+    }
+    
+    if (threephase->phase_loss_callback != NULL) {
+        threephase->phase_loss_callback(threephase, (pc814_phase_id_t)phase, lost);
+    }
+}
+
+/* Phase is lost when its last edge is older than one period plus margin */
+static void check_liveness(pc814_threephase_t *threephase, uint32_t now)
+{
+    for (uint32_t p = 0; p < 3; p++) {
+        uint32_t period = threephase->phase_period[p];
+        
+        if (!(threephase->phase_seen & (1U << p)) || period == 0) {
+            continue;
+        }
+        
+        uint32_t timeout = period + (period / 100U) * threephase->loss_margin;
+        set_phase_lost(threephase, p, (uint32_t)(now - threephase->phase_zc[p]) > timeout);
+    }
+}
+
+/* Single-phasing: keep the angle between the two remaining phases */
+static void update_degraded(pc814_threephase_t *threephase)
+{
+    switch (threephase->phase_lost) {
+        case 0x01:
+            threephase->degraded = update_angle(threephase, PC814_PHASE_B);
+            break;
+        case 0x02:
+            threephase->degraded = update_angle(threephase, PC814_PHASE_C);
+            break;
+        case 0x04:
+            threephase->degraded = update_angle(threephase, PC814_PHASE_A);
+            break;
+        default:
+            threephase->degraded = false;
+            break;
+    }
+}
+
+/* Correction for a non-ABC sequence from the current angles */
+static pc814_diag_code_t swap_code(const pc814_threephase_t *threephase)
+{
+    /* Reverse sequence: swapping B and C is the most common correction */
+    if (threephase->sequence == PC814_SEQUENCE_ACB) {
+        return PC814_DIAG_SWAP_BC;
+    }
+    
+    angle_t ab_angle = angle_get(&threephase->relationship, PC814_PHASE_A);
+    angle_t bc_angle = angle_get(&threephase->relationship, PC814_PHASE_B);
+    angle_t ca_angle = angle_get(&threephase->relationship, PC814_PHASE_C);
+    angle_t tolerance = angle_tolerance(threephase);
+    
+    /* If A->B is 120 and C->A is 120, swapping B and C should fix it */
+    if (is_angle_120(ab_angle, tolerance) && is_angle_120(ca_angle, tolerance)) {
+        return PC814_DIAG_SWAP_BC;
+    }
+    /* If B->C is 120 and C->A is 120, swapping A and B should fix it */
+    if (is_angle_120(bc_angle, tolerance) && is_angle_120(ca_angle, tolerance)) {
+        return PC814_DIAG_SWAP_AB;
+    }
+    /* If A->B is 120 and B->C is 120, but sequence is wrong, swap C and A */
+    if (is_angle_120(ab_angle, tolerance) && is_angle_120(bc_angle, tolerance)) {
+        return PC814_DIAG_SWAP_CA;
+    }
+    
+    return PC814_DIAG_CHECK_WIRING;
+}
+
+/* Refresh cached diagnosis (once per update) */
+static void update_diagnosis(pc814_threephase_t *threephase)
+{
+    pc814_diagnosis_t *diag = &threephase->diagnosis;
+    
+    diag->sequence = threephase->sequence;
+    diag->confidence = pc814_threephase_get_sequence_confidence(threephase);
+    diag->lost_phases = threephase->phase_lost;
+    diag->degraded = threephase->degraded;
+    
+    if (threephase->phase_lost != 0) {
+        diag->code = PC814_DIAG_PHASE_LOSS;
+    } else if (!threephase->relationship.valid || threephase->sequence == PC814_SEQUENCE_UNKNOWN) {
+        diag->code = PC814_DIAG_NO_DATA;
+    } else if (threephase->sequence == PC814_SEQUENCE_ABC) {
+        diag->code = PC814_DIAG_OK;
+    } else {
+        diag->code = swap_code(threephase);
+    }
+}
+
+/* Event-driven update: refresh one phase and the two angles involving it */
+static void threephase_update_phase(pc814_threephase_t *threephase, pc814_phase_id_t phase,
+                                    const pc814_data_t *data)
+{
+    pc814_phase_relationship_t *rel = &threephase->relationship;
+    
+    if (!data->valid) {
+        return;
+    }
+    
+    switch (phase) {
+        case PC814_PHASE_A:
+            rel->phase_a_zc_time = data->timestamp_us;
+            rel->phase_a_freq = data->frequency_hz;
+            break;
+        case PC814_PHASE_B:
+            rel->phase_b_zc_time = data->timestamp_us;
+            rel->phase_b_freq = data->frequency_hz;
+            break;
+        case PC814_PHASE_C:
+            rel->phase_c_zc_time = data->timestamp_us;
+            rel->phase_c_freq = data->frequency_hz;
+            break;
+        default:
+            return;
+    }
+    
+    /* Shared timebase: full timer resolution, otherwise system time */
+    uint32_t zc = (threephase->timebase != NULL) ? data->capture_ticks : data->timestamp_us;
+    uint32_t period = (threephase->timebase != NULL) ? data->period_ticks : data->period_us;
+    
+    threephase->phase_zc[phase] = zc;
+    threephase->phase_period[phase] = period;
+    
+    bool complete = (threephase->phase_seen == 0x07);
+    threephase->phase_seen |= (uint8_t)(1U << phase);
+    
+    /* This edge is 'now' for the other phases' timeouts */
+    check_liveness(threephase, zc);
+    
+    if (threephase->phase_seen != 0x07) {
+        return;
+    }
+    
+    bool matched;
+    if (!complete) {
+        /* All phases just became available: compute every angle once */
+        matched = update_angle(threephase, PC814_PHASE_A);
+        matched = update_angle(threephase, PC814_PHASE_B) && matched;
+        matched = update_angle(threephase, PC814_PHASE_C) && matched;
+    } else {
+        /* Angle to the next phase and from the previous phase */
+        matched = update_angle(threephase, phase);
+        matched = update_angle(threephase, (phase + 2) % 3) && matched;
+    }
+    
+    rel->valid = matched;
+    update_degraded(threephase);
+    threephase->raw_sequence = pc814_threephase_detect_sequence(threephase);
+    
+    /* One vote per cycle, on the reference phase: a bad edge counts once */
+    if (phase == PC814_PHASE_A) {
+        sequence_vote(threephase, threephase->raw_sequence);
+    }
+    update_diagnosis(threephase);
+    threephase->last_update_time = data->timestamp_us;
+    
+    if (threephase->callback != NULL) {
+        threephase->callback(threephase, phase);
+    }
+    
+    /* Angles now include this cycle's reference edge */
+    if (phase == PC814_PHASE_A) {
+        pc814_bus_publish(threephase->phase_a, PC814_BUS_ANGLE_UPDATE);
+    }
+}
+
+/* Capture hook installed on each phase handle */
+static void threephase_capture_hook(void *context, pc814_handle_t *handle)
+{
+    pc814_threephase_t *threephase = (pc814_threephase_t *)context;
+    
+    if (handle == threephase->phase_a) {
+        threephase_update_phase(threephase, PC814_PHASE_A, &handle->data);
+    } else if (handle == threephase->phase_b) {
+        threephase_update_phase(threephase, PC814_PHASE_B, &handle->data);
+    } else if (handle == threephase->phase_c) {
+        threephase_update_phase(threephase, PC814_PHASE_C, &handle->data);
+    }
 }
 
 /* Initialize three-phase system */
@@ -98,7 +535,14 @@ pc814_status_t pc814_threephase_init(pc814_threephase_t *threephase,
     threephase->phase_b = phase_b;
     threephase->phase_c = phase_c;
     threephase->sequence = PC814_SEQUENCE_UNKNOWN;
+    threephase->raw_sequence = PC814_SEQUENCE_UNKNOWN;
+    threephase->candidate = PC814_SEQUENCE_UNKNOWN;
+    threephase->sequence_votes = 1;
+    threephase->loss_margin = PC814_DEFAULT_LOSS_MARGIN;
     threephase->sequence_tolerance = PC814_DEFAULT_SEQUENCE_TOLERANCE;
+    threephase->sequence_tolerance_bam = PC814_BAM_FROM_DEG(PC814_DEFAULT_SEQUENCE_TOLERANCE);
+    threephase->diagnosis.code = PC814_DIAG_NO_DATA;
+    threephase->diagnosis.sequence = PC814_SEQUENCE_UNKNOWN;
     threephase->initialized = true;
     
     return PC814_OK;
@@ -112,46 +556,207 @@ pc814_status_t pc814_threephase_process(pc814_threephase_t *threephase)
     }
     
     pc814_data_t data_a, data_b, data_c;
+    bool valid_a, valid_b, valid_c;
     
-    /* Read data from all three phases */
-    if (pc814_read_data(threephase->phase_a, &data_a) != PC814_OK || !data_a.valid) {
+    /* Read data from all three phases; a phase without valid data is lost */
+    valid_a = (pc814_read_data(threephase->phase_a, &data_a) == PC814_OK) && data_a.valid;
+    valid_b = (pc814_read_data(threephase->phase_b, &data_b) == PC814_OK) && data_b.valid;
+    valid_c = (pc814_read_data(threephase->phase_c, &data_c) == PC814_OK) && data_c.valid;
+    
+    /* Update relationship data */
+    if (valid_a) {
+        threephase->relationship.phase_a_zc_time = data_a.timestamp_us;
+        threephase->relationship.phase_a_freq = data_a.frequency_hz;
+        threephase->phase_zc[PC814_PHASE_A] = data_a.timestamp_us;
+        threephase->phase_period[PC814_PHASE_A] = data_a.period_us;
+        threephase->phase_seen |= 0x01;
+    }
+    if (valid_b) {
+        threephase->relationship.phase_b_zc_time = data_b.timestamp_us;
+        threephase->relationship.phase_b_freq = data_b.frequency_hz;
+        threephase->phase_zc[PC814_PHASE_B] = data_b.timestamp_us;
+        threephase->phase_period[PC814_PHASE_B] = data_b.period_us;
+        threephase->phase_seen |= 0x02;
+    }
+    if (valid_c) {
+        threephase->relationship.phase_c_zc_time = data_c.timestamp_us;
+        threephase->relationship.phase_c_freq = data_c.frequency_hz;
+        threephase->phase_zc[PC814_PHASE_C] = data_c.timestamp_us;
+        threephase->phase_period[PC814_PHASE_C] = data_c.period_us;
+        threephase->phase_seen |= 0x04;
+    }
+    
+    /* Per-phase liveness against the current time, valid flags without a clock */
+    uint32_t now;
+    bool timed = (pc814_get_port_time_us(threephase->phase_a, &now) == PC814_OK);
+    if (timed) {
+        check_liveness(threephase, now);
+    }
+    if (!timed || !valid_a) {
+        set_phase_lost(threephase, PC814_PHASE_A, !valid_a);
+    }
+    if (!timed || !valid_b) {
+        set_phase_lost(threephase, PC814_PHASE_B, !valid_b);
+    }
+    if (!timed || !valid_c) {
+        set_phase_lost(threephase, PC814_PHASE_C, !valid_c);
+    }
+    
+    /* Cycle-matched phase angles, each against its reference phase's period */
+    bool matched = update_angle(threephase, PC814_PHASE_A);
+    matched = update_angle(threephase, PC814_PHASE_B) && matched;
+    matched = update_angle(threephase, PC814_PHASE_C) && matched;
+    
+    /* A stalled or lost phase cannot be paired with the others */
+    threephase->relationship.valid = matched;
+    update_degraded(threephase);
+    sequence_vote(threephase, pc814_threephase_detect_sequence(threephase));
+    update_diagnosis(threephase);
+    pc814_bus_publish(threephase->phase_a, PC814_BUS_ANGLE_UPDATE);
+    if (!matched) {
         return PC814_ERROR;
     }
-    if (pc814_read_data(threephase->phase_b, &data_b) != PC814_OK || !data_b.valid) {
+    
+    threephase->last_update_time = data_a.timestamp_us;
+    
+    return PC814_OK;
+}
+
+/* Enable event-driven mode */
+pc814_status_t pc814_threephase_enable_events(pc814_threephase_t *threephase)
+{
+    if (threephase == NULL || !threephase->initialized) {
         return PC814_ERROR;
     }
-    if (pc814_read_data(threephase->phase_c, &data_c) != PC814_OK || !data_c.valid) {
+    
+    threephase->phase_seen = 0;
+    memset(threephase->phase_period, 0, sizeof(threephase->phase_period));
+    threephase->event_driven = true;
+    
+    pc814_set_capture_hook(threephase->phase_a, threephase_capture_hook, threephase);
+    pc814_set_capture_hook(threephase->phase_b, threephase_capture_hook, threephase);
+    pc814_set_capture_hook(threephase->phase_c, threephase_capture_hook, threephase);
+    
+    return PC814_OK;
+}
+
+/* Disable event-driven mode */
+void pc814_threephase_disable_events(pc814_threephase_t *threephase)
+{
+    if (threephase == NULL || !threephase->initialized) {
+        return;
+    }
+    
+    pc814_set_capture_hook(threephase->phase_a, NULL, NULL);
+    pc814_set_capture_hook(threephase->phase_b, NULL, NULL);
+    pc814_set_capture_hook(threephase->phase_c, NULL, NULL);
+    threephase->event_driven = false;
+}
+
+/* Enable shared-timebase capture */
+pc814_status_t pc814_threephase_set_shared_timebase(pc814_threephase_t *threephase,
+                                                    pc814_timebase_t *timebase)
+{
+    if (threephase == NULL || !threephase->initialized || timebase == NULL) {
         return PC814_ERROR;
     }
     
-    /* Update relationship data */
-    threephase->relationship.phase_a_zc_time = data_a.timestamp_us;
-    threephase->relationship.phase_b_zc_time = data_b.timestamp_us;
-    threephase->relationship.phase_c_zc_time = data_c.timestamp_us;
-    threephase->relationship.phase_a_freq = data_a.frequency_hz;
-    threephase->relationship.phase_b_freq = data_b.frequency_hz;
-    threephase->relationship.phase_c_freq = data_c.frequency_hz;
-    
-    /* Calculate average period for angle calculations */
-    uint32_t avg_period = (data_a.period_us + data_b.period_us + data_c.period_us) / 3;
-    
-    /* Calculate phase angles */
-    threephase->relationship.phase_ab_angle = calculate_phase_angle(
-        data_a.timestamp_us, data_b.timestamp_us, avg_period);
-    threephase->relationship.phase_bc_angle = calculate_phase_angle(
-        data_b.timestamp_us, data_c.timestamp_us, avg_period);
-    threephase->relationship.phase_ca_angle = calculate_phase_angle(
-        data_c.timestamp_us, data_a.timestamp_us, avg_period);
-    
-    /* Detect sequence */
-    threephase->sequence = pc814_threephase_detect_sequence(threephase);
-    
-    threephase->relationship.valid = true;
-    threephase->last_update_time = data_a.timestamp_us;
+    threephase->timebase = timebase;
+    return pc814_threephase_enable_events(threephase);
+}
+
+/* Dispatch one channel capture of the shared timer */
+pc814_status_t pc814_threephase_capture(pc814_threephase_t *threephase,
+                                        pc814_phase_id_t phase,
+                                        uint32_t raw_capture,
+                                        bool overflow_pending)
+{
+    if (threephase == NULL || !threephase->initialized || threephase->timebase == NULL) {
+        return PC814_ERROR;
+    }
+    
+    pc814_handle_t *handle;
+    switch (phase) {
+        case PC814_PHASE_A:
+            handle = threephase->phase_a;
+            break;
+        case PC814_PHASE_B:
+            handle = threephase->phase_b;
+            break;
+        case PC814_PHASE_C:
+            handle = threephase->phase_c;
+            break;
+        default:
+            return PC814_INVALID_PARAM;
+    }
+    
+    uint32_t ticks = pc814_timebase_extend(threephase->timebase, raw_capture, overflow_pending);
+    return pc814_process_capture_value(handle, ticks);
+}
+
+/* Set circular-mean averaging window */
+void pc814_threephase_set_average_window(pc814_threephase_t *threephase, uint16_t cycles)
+{
+    if (threephase == NULL) {
+        return;
+    }
+    
+    threephase->average_window = cycles;
+    memset(threephase->average, 0, sizeof(threephase->average));
+}
+
+/* Get averaged angle statistics */
+pc814_status_t pc814_threephase_get_angle_stats(pc814_threephase_t *threephase,
+                                                pc814_phase_id_t phase,
+                                                pc814_angle_stats_t *stats)
+{
+    if (threephase == NULL || stats == NULL || (uint32_t)phase > PC814_PHASE_C) {
+        return PC814_ERROR;
+    }
+    
+    memset(stats, 0, sizeof(pc814_angle_stats_t));
+    
+    /* Copy the latched window first: the ISR may start the next one */
+    pc814_angle_average_t *avg = &threephase->average[phase];
+    uint16_t count = avg->window_count;
+    int32_t sum_cos = avg->window_cos;
+    int32_t sum_sin = avg->window_sin;
+    
+    if (count == 0) {
+        return PC814_ERROR;
+    }
+    
+    /* Mean direction and spread from the vector sum */
+    float c = (float)sum_cos / (16384.0f * (float)count);
+    float s = (float)sum_sin / (16384.0f * (float)count);
+    float r = sqrtf(c * c + s * s);
+    float mean = atan2f(s, c) * (180.0f / 3.14159265f);
+    
+    if (mean < 0.0f) {
+        mean += 360.0f;
+    }
+    if (r > 1.0f) {
+        r = 1.0f;
+    }
+    
+    stats->mean_deg = mean;
+    stats->resultant = r;
+    stats->std_dev_deg = (r > 0.0f) ? sqrtf(-2.0f * logf(r)) * (180.0f / 3.14159265f) : 180.0f;
+    stats->samples = count;
+    stats->valid = true;
     
     return PC814_OK;
 }
 
+/* Set update callback */
+void pc814_threephase_set_callback(pc814_threephase_t *threephase,
+                                   pc814_threephase_callback_t callback)
+{
+    if (threephase != NULL) {
+        threephase->callback = callback;
+    }
+}
+
 /* Detect phase sequence */
 pc814_sequence_t pc814_threephase_detect_sequence(pc814_threephase_t *threephase)
 {
@@ -159,10 +764,10 @@ pc814_sequence_t pc814_threephase_detect_sequence(pc814_threephase_t *threephase
         return PC814_SEQUENCE_ERROR;
     }
     
-    float ab_angle = threephase->relationship.phase_ab_angle;
-    float bc_angle = threephase->relationship.phase_bc_angle;
-    float ca_angle = threephase->relationship.phase_ca_angle;
-    float tolerance = threephase->sequence_tolerance;
+    angle_t ab_angle = angle_get(&threephase->relationship, PC814_PHASE_A);
+    angle_t bc_angle = angle_get(&threephase->relationship, PC814_PHASE_B);
+    angle_t ca_angle = angle_get(&threephase->relationship, PC814_PHASE_C);
+    angle_t tolerance = angle_tolerance(threephase);
     
     /* Check for ABC sequence (A->B->C: 120° each) */
     /* In correct sequence: A->B = 120°, B->C = 120°, C->A = 120° */
@@ -176,17 +781,12 @@ pc814_sequence_t pc814_threephase_detect_sequence(pc814_threephase_t *threephase
     
     /* Check for ACB sequence (reverse) */
     /* In reverse sequence: A->C = 120°, C->B = 120°, B->A = 120° */
-    /* This means: A->B = 240° (or -120°), B->C = 240°, C->A = 120° */
+    /* This means: A->B = 240° (or -120°), B->C = 240°, C->A = 240° */
     bool ab_240 = is_angle_240(ab_angle, tolerance);
     bool bc_240 = is_angle_240(bc_angle, tolerance);
+    bool ca_240 = is_angle_240(ca_angle, tolerance);
     
-    if ((ab_240 || bc_240) && ca_120) {
-        return PC814_SEQUENCE_ACB;  /* Reverse sequence */
-    }
-    
-    /* Alternative: Check if angles suggest reverse sequence */
-    /* If A->B is close to 240 and B->C is close to 240, it's reverse */
-    if (ab_240 && bc_240) {
+    if (ab_240 && bc_240 && ca_240) {
         return PC814_SEQUENCE_ACB;  /* Reverse sequence */
     }
     
@@ -203,6 +803,115 @@ pc814_sequence_t pc814_threephase_get_sequence(pc814_threephase_t *threephase)
     return threephase->sequence;
 }
 
+/* Set sequence filter */
+pc814_status_t pc814_threephase_set_sequence_filter(pc814_threephase_t *threephase, uint8_t votes)
+{
+    if (threephase == NULL || !threephase->initialized) {
+        return PC814_ERROR;
+    }
+    
+    if (votes == 0 || votes > PC814_SEQUENCE_VOTES_MAX) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    threephase->sequence_votes = votes;
+    threephase->candidate_votes = 0;
+    return PC814_OK;
+}
+
+/* Get unfiltered sequence decision */
+pc814_sequence_t pc814_threephase_get_raw_sequence(pc814_threephase_t *threephase)
+{
+    if (threephase == NULL) {
+        return PC814_SEQUENCE_ERROR;
+    }
+    return threephase->raw_sequence;
+}
+
+/* Get confidence in the confirmed sequence */
+uint8_t pc814_threephase_get_sequence_confidence(pc814_threephase_t *threephase)
+{
+    if (threephase == NULL || threephase->history_len == 0) {
+        return 0;
+    }
+    
+    uint8_t agreed = 0;
+    for (uint8_t i = 0; i < threephase->history_len; i++) {
+        agreed += (uint8_t)((threephase->agree_history >> i) & 1U);
+    }
+    
+    return (uint8_t)((agreed * 100U) / threephase->history_len);
+}
+
+/* Set confirmed sequence change callback */
+void pc814_threephase_set_sequence_callback(pc814_threephase_t *threephase,
+                                            pc814_sequence_callback_t callback)
+{
+    if (threephase != NULL) {
+        threephase->sequence_callback = callback;
+    }
+}
+
+/* Set phase-loss timeout margin */
+pc814_status_t pc814_threephase_set_loss_margin(pc814_threephase_t *threephase, uint8_t percent)
+{
+    if (threephase == NULL || !threephase->initialized) {
+        return PC814_ERROR;
+    }
+    
+    if (percent < 5 || percent > 100) {
+        return PC814_INVALID_PARAM;
+    }
+    
+    threephase->loss_margin = percent;
+    return PC814_OK;
+}
+
+/* Set phase loss callback */
+void pc814_threephase_set_phase_loss_callback(pc814_threephase_t *threephase,
+                                              pc814_phase_loss_callback_t callback)
+{
+    if (threephase != NULL) {
+        threephase->phase_loss_callback = callback;
+    }
+}
+
+/* Get lost phases */
+uint8_t pc814_threephase_get_lost_phases(pc814_threephase_t *threephase)
+{
+    if (threephase == NULL) {
+        return 0;
+    }
+    return threephase->phase_lost;
+}
+
+/* Check if a phase is lost */
+bool pc814_threephase_is_phase_lost(pc814_threephase_t *threephase, pc814_phase_id_t phase)
+{
+    if (threephase == NULL || (uint32_t)phase > PC814_PHASE_C) {
+        return false;
+    }
+    return (threephase->phase_lost & (1U << phase)) != 0;
+}
+
+/* Get angle between the two remaining phases */
+float pc814_threephase_get_degraded_angle(pc814_threephase_t *threephase, pc814_phase_id_t *from)
+{
+    if (threephase == NULL || !threephase->degraded) {
+        return -1.0f;
+    }
+    
+    /* The surviving pair starts at the phase after the lost one */
+    uint32_t lost = (threephase->phase_lost == 0x01) ? 0U : (threephase->phase_lost == 0x02) ? 1U : 2U;
+    uint32_t first = (lost + 1) % 3;
+    
+    if (from != NULL) {
+        *from = (pc814_phase_id_t)first;
+    }
+    
+    return ANGLE_TO_DEG(angle_get(&threephase->relationship, first));
+}
+
 /* Check if sequence is correct */
 bool pc814_threephase_is_sequence_correct(pc814_threephase_t *threephase)
 {
@@ -221,6 +930,13 @@ pc814_status_t pc814_threephase_get_relationship(pc814_threephase_t *threephase,
     }
     
     memcpy(relationship, &threephase->relationship, sizeof(pc814_phase_relationship_t));
+    
+#ifdef PC814_THREEPHASE_FIXED_POINT
+    relationship->phase_ab_angle = PC814_BAM_TO_DEG(relationship->phase_ab_bam);
+    relationship->phase_bc_angle = PC814_BAM_TO_DEG(relationship->phase_bc_bam);
+    relationship->phase_ca_angle = PC814_BAM_TO_DEG(relationship->phase_ca_bam);
+#endif
+    
     return PC814_OK;
 }
 
@@ -237,26 +953,17 @@ float pc814_threephase_get_phase_angle(pc814_threephase_t *threephase,
         return 0.0f;
     }
     
-    /* Get angle based on phase combination */
-    if (phase1 == PC814_PHASE_A && phase2 == PC814_PHASE_B) {
-        return threephase->relationship.phase_ab_angle;
-    } else if (phase1 == PC814_PHASE_B && phase2 == PC814_PHASE_C) {
-        return threephase->relationship.phase_bc_angle;
-    } else if (phase1 == PC814_PHASE_C && phase2 == PC814_PHASE_A) {
-        return threephase->relationship.phase_ca_angle;
-    } else if (phase1 == PC814_PHASE_B && phase2 == PC814_PHASE_A) {
-        /* Reverse: 360 - angle */
-        float angle = threephase->relationship.phase_ab_angle;
-        return (angle > 0) ? (360.0f - angle) : 0.0f;
-    } else if (phase1 == PC814_PHASE_C && phase2 == PC814_PHASE_B) {
-        float angle = threephase->relationship.phase_bc_angle;
-        return (angle > 0) ? (360.0f - angle) : 0.0f;
-    } else if (phase1 == PC814_PHASE_A && phase2 == PC814_PHASE_C) {
-        float angle = threephase->relationship.phase_ca_angle;
-        return (angle > 0) ? (360.0f - angle) : 0.0f;
+    if ((uint32_t)phase1 > PC814_PHASE_C || (uint32_t)phase2 > PC814_PHASE_C) {
+        return 0.0f;
+    }
+    
+    /* Forward pair (A->B, B->C, C->A) or reverse pair (360 - angle) */
+    if (phase2 == (phase1 + 1) % 3) {
+        return ANGLE_TO_DEG(angle_get(&threephase->relationship, phase1));
     }
     
-    return 0.0f;
+    pc814_bam_t reverse = (pc814_bam_t)(0U - ANGLE_TO_BAM(angle_get(&threephase->relationship, phase2)));
+    return PC814_BAM_TO_DEG(reverse);
 }
 
 /* Get frequency of specific phase */
@@ -297,36 +1004,55 @@ pc814_status_t pc814_threephase_get_swap_recommendation(pc814_threephase_t *thre
         return PC814_ERROR;
     }
     
-    /* If sequence is ACB (reverse), recommend swapping B and C */
-    /* This is the most common correction for reverse sequence */
-    if (threephase->sequence == PC814_SEQUENCE_ACB) {
-        *swap_bc = true;
-        return PC814_OK;
+    if (threephase->sequence == PC814_SEQUENCE_ACB || threephase->sequence == PC814_SEQUENCE_ERROR) {
+        pc814_diag_code_t code = swap_code(threephase);
+        *swap_ab = (code == PC814_DIAG_SWAP_AB);
+        *swap_bc = (code == PC814_DIAG_SWAP_BC);
+        *swap_ca = (code == PC814_DIAG_SWAP_CA);
     }
     
-    if (threephase->sequence == PC814_SEQUENCE_ERROR) {
-        /* Analyze angles to determine what needs to be swapped */
-        float ab_angle = threephase->relationship.phase_ab_angle;
-        float bc_angle = threephase->relationship.phase_bc_angle;
-        float ca_angle = threephase->relationship.phase_ca_angle;
-        float tolerance = threephase->sequence_tolerance;
-        
-        /* Analyze angles to determine what needs to be swapped */
-        /* If A->B is 120 and C->A is 120, swapping B and C should fix it */
-        if (is_angle_120(ab_angle, tolerance) && is_angle_120(ca_angle, tolerance)) {
-            *swap_bc = true;
-        }
-        /* If B->C is 120 and C->A is 120, swapping A and B should fix it */
-        else if (is_angle_120(bc_angle, tolerance) && is_angle_120(ca_angle, tolerance)) {
-            *swap_ab = true;
-        }
-        /* If A->B is 120 and B->C is 120, but sequence is wrong, swap C and A */
-        else if (is_angle_120(ab_angle, tolerance) && is_angle_120(bc_angle, tolerance)) {
-            *swap_ca = true;
-        }
+    return PC814_OK;
+}
+
+/* Message per diagnosis code */
+static const char *const diagnosis_strings[PC814_DIAG_COUNT] = {
+    "Phase sequence is CORRECT (ABC)",
+    "SWAP phases A and B to correct sequence",
+    "SWAP phases B and C to correct sequence",
+    "SWAP phases C and A to correct sequence",
+    "Phase sequence error - check all connections",
+    "Phase loss detected - check supply and fuses",
+    "Error: Cannot determine phase correction"
+};
+
+/* Get cached diagnosis */
+pc814_status_t pc814_threephase_get_diagnosis(pc814_threephase_t *threephase,
+                                               pc814_diagnosis_t *diagnosis)
+{
+    if (threephase == NULL || diagnosis == NULL) {
+        return PC814_ERROR;
     }
     
-    return PC814_OK;
+    memcpy(diagnosis, &threephase->diagnosis, sizeof(pc814_diagnosis_t));
+    return (diagnosis->code == PC814_DIAG_NO_DATA) ? PC814_ERROR : PC814_OK;
+}
+
+/* Get cached diagnosis code */
+pc814_diag_code_t pc814_threephase_get_diagnosis_code(pc814_threephase_t *threephase)
+{
+    if (threephase == NULL || !threephase->initialized) {
+        return PC814_DIAG_NO_DATA;
+    }
+    return threephase->diagnosis.code;
+}
+
+/* Get message for diagnosis code */
+const char *pc814_threephase_get_diagnosis_string(pc814_diag_code_t code)
+{
+    if ((uint32_t)code >= PC814_DIAG_COUNT) {
+        code = PC814_DIAG_NO_DATA;
+    }
+    return diagnosis_strings[code];
 }
 
 /* Get phase order correction message */
@@ -338,33 +1064,12 @@ pc814_status_t pc814_threephase_get_correction_message(pc814_threephase_t *three
         return PC814_ERROR;
     }
     
-    bool swap_ab, swap_bc, swap_ca;
-    if (pc814_threephase_get_swap_recommendation(threephase, &swap_ab, &swap_bc, &swap_ca) != PC814_OK) {
-        strncpy(message, "Error: Cannot determine phase correction", max_len - 1);
-        message[max_len - 1] = '\0';
-        return PC814_ERROR;
-    }
-    
-    if (threephase->sequence == PC814_SEQUENCE_ABC) {
-        strncpy(message, "Phase sequence is CORRECT (ABC)", max_len - 1);
-        message[max_len - 1] = '\0';
-        return PC814_OK;
-    }
-    
-    if (swap_ab && swap_bc && swap_ca) {
-        strncpy(message, "Error: All phases need correction - check connections", max_len - 1);
-    } else if (swap_ab) {
-        strncpy(message, "SWAP phases A and B to correct sequence", max_len - 1);
-    } else if (swap_bc) {
-        strncpy(message, "SWAP phases B and C to correct sequence", max_len - 1);
-    } else if (swap_ca) {
-        strncpy(message, "SWAP phases C and A to correct sequence", max_len - 1);
-    } else {
-        strncpy(message, "Phase sequence error - check all connections", max_len - 1);
-    }
+    pc814_diag_code_t code = threephase->diagnosis.code;
     
+    strncpy(message, pc814_threephase_get_diagnosis_string(code), max_len - 1);
     message[max_len - 1] = '\0';
-    return PC814_OK;
+    
+    return (code == PC814_DIAG_NO_DATA) ? PC814_ERROR : PC814_OK;
 }
 
 /* Set sequence tolerance */
@@ -372,6 +1077,7 @@ void pc814_threephase_set_tolerance(pc814_threephase_t *threephase, float tolera
 {
     if (threephase != NULL && tolerance > 0.0f && tolerance <= 30.0f) {
         threephase->sequence_tolerance = tolerance;
+        threephase->sequence_tolerance_bam = PC814_BAM_FROM_DEG(tolerance);
     }
 }
 
@@ -404,22 +1110,16 @@ float pc814_threephase_get_imbalance(pc814_threephase_t *threephase)
         return -1.0f;
     }
     
-    float ab_angle = threephase->relationship.phase_ab_angle;
-    float bc_angle = threephase->relationship.phase_bc_angle;
-    float ca_angle = threephase->relationship.phase_ca_angle;
-    
-    /* Calculate deviation from 120 degrees */
-    float ab_dev = fabsf(ab_angle - 120.0f);
-    float bc_dev = fabsf(bc_angle - 120.0f);
-    float ca_dev = fabsf(ca_angle - 120.0f);
-    
-    /* Average deviation */
-    float avg_dev = (ab_dev + bc_dev + ca_dev) / 3.0f;
+    /* Nominal angle is 120 degrees for ABC and 240 degrees for ACB */
+    angle_t nominal = (threephase->sequence == PC814_SEQUENCE_ACB) ? ANGLE_240 : ANGLE_120;
     
-    /* Convert to percentage */
-    float imbalance = (avg_dev / 120.0f) * 100.0f;
+    /* Sum of deviations from nominal angle */
+    float dev_sum = (float)angle_distance(angle_get(&threephase->relationship, PC814_PHASE_A), nominal)
+                  + (float)angle_distance(angle_get(&threephase->relationship, PC814_PHASE_B), nominal)
+                  + (float)angle_distance(angle_get(&threephase->relationship, PC814_PHASE_C), nominal);
     
-    return imbalance;
+    /* Average deviation as percentage of 120 degrees */
+    return (ANGLE_TO_DEG(dev_sum) / 3.0f / 120.0f) * 100.0f;
 }
 
 /* Reset three-phase system */
@@ -430,7 +1130,20 @@ void pc814_threephase_reset(pc814_threephase_t *threephase)
     }
     
     threephase->sequence = PC814_SEQUENCE_UNKNOWN;
+    threephase->raw_sequence = PC814_SEQUENCE_UNKNOWN;
+    threephase->candidate = PC814_SEQUENCE_UNKNOWN;
+    threephase->candidate_votes = 0;
+    threephase->agree_history = 0;
+    threephase->history_len = 0;
+    threephase->phase_lost = 0;
+    threephase->degraded = false;
     threephase->relationship.valid = false;
     memset(&threephase->relationship, 0, sizeof(pc814_phase_relationship_t));
+    threephase->phase_seen = 0;
+    memset(threephase->phase_period, 0, sizeof(threephase->phase_period));
+    memset(threephase->average, 0, sizeof(threephase->average));
+    memset(&threephase->diagnosis, 0, sizeof(pc814_diagnosis_t));
+    threephase->diagnosis.code = PC814_DIAG_NO_DATA;
+    threephase->diagnosis.sequence = PC814_SEQUENCE_UNKNOWN;
 }
 
@@ -22,6 +22,21 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 
+/*
+ * Define PC814_THREEPHASE_FIXED_POINT to run all angle math (capture path,
+ * sequence detection, imbalance) in 16-bit binary angles instead of float.
+ * Intended for FPU-less parts; the float API stays available and is filled
+ * from the binary angles by the getters.
+ */
+
+/* Binary angle: 65536 = 360 degrees, wraps naturally */
+typedef uint16_t pc814_bam_t;
+
+#define PC814_BAM_FROM_DEG(deg)  ((pc814_bam_t)(int32_t)((deg) * (65536.0f / 360.0f) + 0.5f))
+#define PC814_BAM_TO_DEG(bam)    ((float)(bam) * (360.0f / 65536.0f))
+#define PC814_BAM_120            ((pc814_bam_t)0x5555)  /* Nominal 120 degrees */
+#define PC814_BAM_240            ((pc814_bam_t)0xAAAB)  /* Nominal 240 degrees */
+
 /* Phase sequence types */
 typedef enum {
     PC814_SEQUENCE_ABC = 0,      /* Correct sequence: A-B-C (120° apart) */
@@ -48,20 +63,120 @@ typedef struct {
     uint32_t phase_a_freq;       /* Frequency of phase A (Hz) */
     uint32_t phase_b_freq;       /* Frequency of phase B (Hz) */
     uint32_t phase_c_freq;       /* Frequency of phase C (Hz) */
+    pc814_bam_t phase_ab_bam;    /* Phase angle between A and B (binary angle) */
+    pc814_bam_t phase_bc_bam;    /* Phase angle between B and C (binary angle) */
+    pc814_bam_t phase_ca_bam;    /* Phase angle between C and A (binary angle) */
     bool valid;                  /* Data validity flag */
 } pc814_phase_relationship_t;
 
+/* Circular-mean angle statistics over one window */
+typedef struct {
+    float mean_deg;              /* Circular mean angle (degrees, 0-360) */
+    float std_dev_deg;           /* Circular standard deviation (degrees) */
+    float resultant;             /* Mean resultant length (1 = no spread) */
+    uint16_t samples;            /* Samples in the window */
+    bool valid;                  /* At least one window completed */
+} pc814_angle_stats_t;
+
+/* Circular-mean accumulator (fixed-point vector sum) */
+typedef struct {
+    int32_t sum_cos;             /* Sum of cos(angle), Q14 */
+    int32_t sum_sin;             /* Sum of sin(angle), Q14 */
+    uint16_t count;              /* Samples accumulated */
+    uint32_t last_zc;            /* Reference edge of last sample */
+    int32_t window_cos;          /* Sum of cos over last completed window, Q14 */
+    int32_t window_sin;          /* Sum of sin over last completed window, Q14 */
+    uint16_t window_count;       /* Samples in last completed window (0 = none) */
+} pc814_angle_average_t;
+
 /* Three-phase system handle */
+typedef struct pc814_threephase_s pc814_threephase_t;
+
+/* Three-phase update callback (event-driven mode, interrupt context) */
+typedef void (*pc814_threephase_callback_t)(pc814_threephase_t *threephase, pc814_phase_id_t phase);
+
+/* Confirmed sequence change callback */
+typedef void (*pc814_sequence_callback_t)(pc814_threephase_t *threephase,
+                                          pc814_sequence_t old_sequence,
+                                          pc814_sequence_t new_sequence);
+
+/* Phase lost (lost = true) or restored (lost = false) callback */
+typedef void (*pc814_phase_loss_callback_t)(pc814_threephase_t *threephase,
+                                            pc814_phase_id_t phase,
+                                            bool lost);
+
+/* Diagnosis code (one per state, see pc814_threephase_get_diagnosis_string) */
+typedef enum {
+    PC814_DIAG_OK = 0,           /* Sequence correct (ABC) */
+    PC814_DIAG_SWAP_AB = 1,      /* Swap phases A and B */
+    PC814_DIAG_SWAP_BC = 2,      /* Swap phases B and C */
+    PC814_DIAG_SWAP_CA = 3,      /* Swap phases C and A */
+    PC814_DIAG_CHECK_WIRING = 4, /* Sequence error no single swap corrects */
+    PC814_DIAG_PHASE_LOSS = 5,   /* One or more phases lost */
+    PC814_DIAG_NO_DATA = 6,      /* Sequence not yet determined */
+    PC814_DIAG_COUNT
+} pc814_diag_code_t;
+
+/* Diagnosis cached at each update */
 typedef struct {
+    pc814_diag_code_t code;      /* Recommended action */
+    pc814_sequence_t sequence;   /* Confirmed sequence */
+    uint8_t confidence;          /* Sequence confidence (0-100 %) */
+    uint8_t lost_phases;         /* Bit mask of lost phases */
+    bool degraded;               /* Remaining pair angle valid */
+} pc814_diagnosis_t;
+
+/* Maximum consistent decisions required to change the confirmed sequence */
+#define PC814_SEQUENCE_VOTES_MAX 16
+
+struct pc814_threephase_s {
     pc814_handle_t *phase_a;     /* Handle for phase A */
     pc814_handle_t *phase_b;     /* Handle for phase B */
     pc814_handle_t *phase_c;     /* Handle for phase C */
-    pc814_sequence_t sequence;   /* Detected phase sequence */
+    pc814_sequence_t sequence;   /* Confirmed (debounced) phase sequence */
+    pc814_sequence_t raw_sequence; /* Decision from the latest angles */
+    pc814_sequence_t candidate;  /* Sequence collecting votes to replace 'sequence' */
+    uint8_t candidate_votes;     /* Consecutive decisions for 'candidate' */
+    uint8_t sequence_votes;      /* Decisions required to change (1 = no filtering) */
+    uint16_t agree_history;      /* Bit per recent decision, 1 = agreed with 'sequence' */
+    uint8_t history_len;         /* Valid bits in agree_history (0-16) */
+    pc814_sequence_callback_t sequence_callback; /* Confirmed change callback */
+    uint8_t phase_lost;          /* Bit mask of phases that timed out */
+    uint8_t loss_margin;         /* Loss timeout beyond one period (percent) */
+    bool degraded;               /* One phase lost, remaining pair angle valid */
+    pc814_phase_loss_callback_t phase_loss_callback; /* Phase loss/restore callback */
+    pc814_diagnosis_t diagnosis; /* Diagnosis from the last update */
     pc814_phase_relationship_t relationship; /* Phase relationships */
     uint32_t last_update_time;  /* Last update timestamp */
     float sequence_tolerance;    /* Tolerance for sequence detection (degrees) */
+    pc814_bam_t sequence_tolerance_bam; /* Same tolerance as binary angle */
     bool initialized;            /* Initialization flag */
-} pc814_threephase_t;
+    bool event_driven;           /* Updated from each phase's capture */
+    uint8_t phase_seen;          /* Bit mask of phases with valid data */
+    uint32_t phase_zc[3];        /* Last zero-crossing per phase (angle time units) */
+    uint32_t phase_period[3];    /* Last valid period per phase (angle time units) */
+    pc814_timebase_t *timebase;  /* Shared timebase (NULL: angles from get_time_us) */
+    pc814_threephase_callback_t callback; /* Update callback */
+    uint16_t average_window;     /* Cycles per averaging window (0 = off) */
+    pc814_angle_average_t average[3]; /* AB, BC, CA angle averages */
+};
+
+/**
+ * Binary angle of time2 after time1 (integer only)
+ * @param time1 Reference zero-crossing time
+ * @param time2 Other zero-crossing time (may be older than time1)
+ * @param period Period in the same time units
+ * @return Angle 0-65535 (65536 = 360°), 0 if period is 0
+ */
+pc814_bam_t pc814_bam_phase_angle(uint32_t time1, uint32_t time2, uint32_t period);
+
+/**
+ * Absolute distance between two binary angles, shortest way round
+ * @param angle Angle to check
+ * @param nominal Nominal angle
+ * @return Distance 0-32768 (32768 = 180°)
+ */
+pc814_bam_t pc814_bam_distance(pc814_bam_t angle, pc814_bam_t nominal);
 
 /**
  * Initialize three-phase system
@@ -83,6 +198,117 @@ pc814_status_t pc814_threephase_init(pc814_threephase_t *threephase,
  */
 pc814_status_t pc814_threephase_process(pc814_threephase_t *threephase);
 
+/**
+ * Enable event-driven mode
+ * Each phase's capture path updates only the two angles that involve that
+ * phase, so no periodic pc814_threephase_process call is needed. Installs
+ * the capture hook on all three handles.
+ * @param threephase Pointer to three-phase handle
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_threephase_enable_events(pc814_threephase_t *threephase);
+
+/**
+ * Disable event-driven mode (removes capture hooks)
+ * @param threephase Pointer to three-phase handle
+ */
+void pc814_threephase_disable_events(pc814_threephase_t *threephase);
+
+/**
+ * Enable shared-timebase capture (phases A/B/C on three channels of one timer)
+ * Angles are computed from raw timer ticks instead of get_time_us. Enables
+ * event-driven mode. Feed captures through pc814_threephase_capture.
+ * @param threephase Pointer to three-phase handle
+ * @param timebase Extended timebase of the shared timer
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_threephase_set_shared_timebase(pc814_threephase_t *threephase,
+                                                    pc814_timebase_t *timebase);
+
+/**
+ * Dispatch one channel capture of the shared timer (call from the timer ISR)
+ * @param threephase Pointer to three-phase handle
+ * @param phase Phase whose channel captured
+ * @param raw_capture Raw capture register value
+ * @param overflow_pending true if the timer overflow flag is set but not yet counted
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_threephase_capture(pc814_threephase_t *threephase,
+                                        pc814_phase_id_t phase,
+                                        uint32_t raw_capture,
+                                        bool overflow_pending);
+
+/**
+ * Set update callback (called after each event-driven update)
+ * @param threephase Pointer to three-phase handle
+ * @param callback Callback function pointer
+ */
+void pc814_threephase_set_callback(pc814_threephase_t *threephase,
+                                   pc814_threephase_callback_t callback);
+
+/**
+ * Set circular-mean averaging window for AB/BC/CA angles
+ * Every new cycle's angle is added as a fixed-point unit vector; after
+ * 'cycles' samples the window sum is latched. Mean and standard deviation
+ * are derived from it in pc814_threephase_get_angle_stats, not in the ISR.
+ * @param threephase Pointer to three-phase handle
+ * @param cycles Samples per window (0 disables averaging)
+ */
+void pc814_threephase_set_average_window(pc814_threephase_t *threephase, uint16_t cycles);
+
+/**
+ * Get averaged angle statistics from one phase to the next
+ * @param threephase Pointer to three-phase handle
+ * @param phase Reference phase (A: A-B, B: B-C, C: C-A)
+ * @param stats Pointer to statistics structure to fill
+ * @return PC814_OK on success, PC814_ERROR if no window completed yet
+ */
+pc814_status_t pc814_threephase_get_angle_stats(pc814_threephase_t *threephase,
+                                                pc814_phase_id_t phase,
+                                                pc814_angle_stats_t *stats);
+
+/**
+ * Set phase-loss timeout margin
+ * A phase is lost when no zero-crossing arrived within one period plus
+ * this margin. In event-driven mode every other phase's edge checks it,
+ * so single-phasing is reported within about one cycle.
+ * @param threephase Pointer to three-phase handle
+ * @param percent Margin in percent of the period (5-100, default 25)
+ * @return PC814_OK on success, PC814_INVALID_PARAM if out of range
+ */
+pc814_status_t pc814_threephase_set_loss_margin(pc814_threephase_t *threephase, uint8_t percent);
+
+/**
+ * Set phase loss callback (called on loss and on restore)
+ * @param threephase Pointer to three-phase handle
+ * @param callback Callback function pointer
+ */
+void pc814_threephase_set_phase_loss_callback(pc814_threephase_t *threephase,
+                                              pc814_phase_loss_callback_t callback);
+
+/**
+ * Get lost phases
+ * @param threephase Pointer to three-phase handle
+ * @return Bit mask (bit 0 = A, bit 1 = B, bit 2 = C)
+ */
+uint8_t pc814_threephase_get_lost_phases(pc814_threephase_t *threephase);
+
+/**
+ * Check if a phase is lost
+ * @param threephase Pointer to three-phase handle
+ * @param phase Phase ID
+ * @return true if the phase timed out
+ */
+bool pc814_threephase_is_phase_lost(pc814_threephase_t *threephase, pc814_phase_id_t phase);
+
+/**
+ * Get angle between the two remaining phases (degraded mode)
+ * @param threephase Pointer to three-phase handle
+ * @param from Pointer to store the first phase of the pair (may be NULL)
+ * @return Angle from 'from' to the next phase in degrees, negative if not degraded
+ */
+float pc814_threephase_get_degraded_angle(pc814_threephase_t *threephase, pc814_phase_id_t *from);
+
 /**
  * Detect phase sequence
  * @param threephase Pointer to three-phase handle
@@ -93,10 +319,45 @@ pc814_sequence_t pc814_threephase_detect_sequence(pc814_threephase_t *threephase
 /**
  * Get current phase sequence
  * @param threephase Pointer to three-phase handle
- * @return Current sequence
+ * @return Confirmed sequence (debounced when a sequence filter is set)
  */
 pc814_sequence_t pc814_threephase_get_sequence(pc814_threephase_t *threephase);
 
+/**
+ * Set sequence filter
+ * The confirmed sequence changes only after 'votes' consecutive decisions
+ * agree on the new value, so single noisy edges do not flip it. One decision
+ * is made per pc814_threephase_process call, or per phase A zero-crossing
+ * in event-driven mode.
+ * @param threephase Pointer to three-phase handle
+ * @param votes Consistent decisions required (1 to PC814_SEQUENCE_VOTES_MAX, default 1)
+ * @return PC814_OK on success, PC814_INVALID_PARAM if votes is out of range
+ */
+pc814_status_t pc814_threephase_set_sequence_filter(pc814_threephase_t *threephase, uint8_t votes);
+
+/**
+ * Get unfiltered sequence decision from the latest angles
+ * @param threephase Pointer to three-phase handle
+ * @return Latest raw decision
+ */
+pc814_sequence_t pc814_threephase_get_raw_sequence(pc814_threephase_t *threephase);
+
+/**
+ * Get confidence in the confirmed sequence
+ * @param threephase Pointer to three-phase handle
+ * @return Percentage of the last (up to 16) decisions that agreed with it
+ */
+uint8_t pc814_threephase_get_sequence_confidence(pc814_threephase_t *threephase);
+
+/**
+ * Set confirmed sequence change callback
+ * Called from the update path (interrupt context in event-driven mode).
+ * @param threephase Pointer to three-phase handle
+ * @param callback Callback function pointer
+ */
+void pc814_threephase_set_sequence_callback(pc814_threephase_t *threephase,
+                                            pc814_sequence_callback_t callback);
+
 /**
  * Check if phase sequence is correct
  * @param threephase Pointer to three-phase handle
@@ -106,6 +367,7 @@ bool pc814_threephase_is_sequence_correct(pc814_threephase_t *threephase);
 
 /**
  * Get phase relationship data
+ * In fixed-point builds the float angles are filled here from the binary angles.
  * @param threephase Pointer to three-phase handle
  * @param relationship Pointer to relationship structure
  * @return PC814_OK on success
@@ -146,12 +408,37 @@ pc814_status_t pc814_threephase_get_swap_recommendation(pc814_threephase_t *thre
                                                          bool *swap_bc,
                                                          bool *swap_ca);
 
+/**
+ * Get diagnosis from the last update
+ * Computed once per update; reading it does no angle math.
+ * @param threephase Pointer to three-phase handle
+ * @param diagnosis Pointer to diagnosis structure to fill
+ * @return PC814_OK on success, PC814_ERROR if code is PC814_DIAG_NO_DATA
+ */
+pc814_status_t pc814_threephase_get_diagnosis(pc814_threephase_t *threephase,
+                                               pc814_diagnosis_t *diagnosis);
+
+/**
+ * Get diagnosis code from the last update
+ * @param threephase Pointer to three-phase handle
+ * @return Diagnosis code, PC814_DIAG_NO_DATA on error
+ */
+pc814_diag_code_t pc814_threephase_get_diagnosis_code(pc814_threephase_t *threephase);
+
+/**
+ * Get message for a diagnosis code
+ * @param code Diagnosis code
+ * @return Constant message string (never NULL)
+ */
+const char *pc814_threephase_get_diagnosis_string(pc814_diag_code_t code);
+
 /**
  * Get phase order correction message
+ * Copies the string for the cached diagnosis code.
  * @param threephase Pointer to three-phase handle
- * @param message Buffer to store message (at least 128 bytes)
+ * @param message Buffer to store message (at least 64 bytes)
  * @param max_len Maximum message length
- * @return PC814_OK on success
+ * @return PC814_OK on success, PC814_ERROR if no diagnosis is available
  */
 pc814_status_t pc814_threephase_get_correction_message(pc814_threephase_t *threephase,
                                                         char *message,
@@ -9,6 +9,7 @@
  */
 
 #include "PC814_ThreePhase.h"
+#include "PC814_Dispatch.h"
 #include "PC814.h"
 #include "stm32f4xx_hal.h"
 #include <stdio.h>
@@ -21,10 +22,77 @@ static pc814_handle_t pc814_phase_c;
 /* Three-phase system handle */
 static pc814_threephase_t threephase_system;
 
-/* Port functions for each phase (can be same or different) */
-extern pc814_port_t pc814_port_a;
-extern pc814_port_t pc814_port_b;
-extern pc814_port_t pc814_port_c;
+/* ========== Context Port (one driver for all three phases) ========== */
+
+/* Input channel descriptor passed to the port as context */
+typedef struct {
+    TIM_HandleTypeDef *htim;     /* Capture timer */
+    uint32_t channel;            /* Timer channel */
+    GPIO_TypeDef *gpio_port;     /* Input pin port */
+    uint16_t gpio_pin;           /* Input pin */
+} phase_channel_t;
+
+extern TIM_HandleTypeDef htim2;
+
+static phase_channel_t channel_a = { &htim2, TIM_CHANNEL_1, GPIOA, GPIO_PIN_0 };
+static phase_channel_t channel_b = { &htim2, TIM_CHANNEL_2, GPIOA, GPIO_PIN_1 };
+static phase_channel_t channel_c = { &htim2, TIM_CHANNEL_3, GPIOA, GPIO_PIN_2 };
+
+/* Get timer capture value of the channel */
+static uint32_t channel_get_capture_value(void *ctx)
+{
+    phase_channel_t *ch = (phase_channel_t *)ctx;
+    return HAL_TIM_ReadCapturedValue(ch->htim, ch->channel);
+}
+
+/* Get timer frequency (1 MHz timer clock) */
+static uint32_t channel_get_frequency(void *ctx)
+{
+    (void)ctx;
+    return 1000000;
+}
+
+/* Start capture on the channel */
+static void channel_start_capture(void *ctx)
+{
+    phase_channel_t *ch = (phase_channel_t *)ctx;
+    HAL_TIM_IC_Start_IT(ch->htim, ch->channel);
+}
+
+/* Stop capture on the channel */
+static void channel_stop_capture(void *ctx)
+{
+    phase_channel_t *ch = (phase_channel_t *)ctx;
+    HAL_TIM_IC_Stop_IT(ch->htim, ch->channel);
+}
+
+/* Set GPIO pull-up on the channel's pin */
+static void channel_set_pull_up(void *ctx)
+{
+    phase_channel_t *ch = (phase_channel_t *)ctx;
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    GPIO_InitStruct.Pin = ch->gpio_pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(ch->gpio_port, &GPIO_InitStruct);
+}
+
+/* Get system time in microseconds */
+static uint32_t channel_get_time_us(void *ctx)
+{
+    (void)ctx;
+    return HAL_GetTick() * 1000;
+}
+
+/* One port structure shared by all phase handles */
+static const pc814_port_v2_t phase_port = {
+    .timer_get_capture_value = channel_get_capture_value,
+    .timer_get_frequency = channel_get_frequency,
+    .timer_start_capture = channel_start_capture,
+    .timer_stop_capture = channel_stop_capture,
+    .gpio_set_pull_up = channel_set_pull_up,
+    .get_time_us = channel_get_time_us
+};
 
 /* ========== Example Functions ========== */
 
@@ -36,22 +104,22 @@ void PC814_ThreePhase_Init(void)
     pc814_status_t status;
     
     /* Initialize each phase */
-    status = pc814_init(&pc814_phase_a, &pc814_port_a, 
-                       PC814_PULL_UP, PC814_EDGE_RISING);
+    status = pc814_init_v2(&pc814_phase_a, &phase_port, &channel_a,
+                           PC814_PULL_UP, PC814_EDGE_RISING);
     if (status != PC814_OK) {
         printf("Phase A init failed!\r\n");
         return;
     }
     
-    status = pc814_init(&pc814_phase_b, &pc814_port_b, 
-                       PC814_PULL_UP, PC814_EDGE_RISING);
+    status = pc814_init_v2(&pc814_phase_b, &phase_port, &channel_b,
+                           PC814_PULL_UP, PC814_EDGE_RISING);
     if (status != PC814_OK) {
         printf("Phase B init failed!\r\n");
         return;
     }
     
-    status = pc814_init(&pc814_phase_c, &pc814_port_c, 
-                       PC814_PULL_UP, PC814_EDGE_RISING);
+    status = pc814_init_v2(&pc814_phase_c, &phase_port, &channel_c,
+                           PC814_PULL_UP, PC814_EDGE_RISING);
     if (status != PC814_OK) {
         printf("Phase C init failed!\r\n");
         return;
@@ -279,6 +347,195 @@ void PC814_ThreePhase_MonitorSequence(void)
     }
 }
 
+/**
+ * Three-phase update callback (interrupt context - keep it short)
+ */
+void PC814_ThreePhase_UpdateCallback(pc814_threephase_t *threephase, pc814_phase_id_t phase)
+{
+    (void)phase;
+    
+    /* Angles involving 'phase' were just refreshed */
+    if (threephase->sequence == PC814_SEQUENCE_ACB) {
+        /* e.g. block motor start interlock */
+    }
+}
+
+/**
+ * Event-driven mode: angles update on every phase's zero-crossing, no polling
+ */
+void PC814_ThreePhase_EnableEvents(void)
+{
+    pc814_threephase_set_callback(&threephase_system, PC814_ThreePhase_UpdateCallback);
+    pc814_threephase_enable_events(&threephase_system);
+}
+
+/**
+ * Confirmed sequence change callback (motor start interlock)
+ */
+void PC814_ThreePhase_SequenceCallback(pc814_threephase_t *threephase,
+                                       pc814_sequence_t old_sequence,
+                                       pc814_sequence_t new_sequence)
+{
+    (void)threephase;
+    (void)old_sequence;
+    
+    if (new_sequence == PC814_SEQUENCE_ABC) {
+        /* e.g. release motor start interlock */
+    } else {
+        /* e.g. block motor start interlock */
+    }
+}
+
+/**
+ * Debounced sequence: 5 consistent cycles required to change state
+ */
+void PC814_ThreePhase_EnableSequenceFilter(void)
+{
+    pc814_threephase_set_sequence_filter(&threephase_system, 5);
+    pc814_threephase_set_sequence_callback(&threephase_system, PC814_ThreePhase_SequenceCallback);
+}
+
+/**
+ * Phase loss callback (interrupt context in event-driven mode)
+ */
+void PC814_ThreePhase_PhaseLossCallback(pc814_threephase_t *threephase,
+                                        pc814_phase_id_t phase,
+                                        bool lost)
+{
+    (void)threephase;
+    (void)phase;
+    
+    if (lost) {
+        /* e.g. trip motor protection relay: single-phasing */
+    }
+}
+
+/**
+ * Phase-loss protection: trip within about one cycle of a missing phase
+ */
+void PC814_ThreePhase_EnablePhaseLoss(void)
+{
+    pc814_threephase_set_loss_margin(&threephase_system, 25);
+    pc814_threephase_set_phase_loss_callback(&threephase_system, PC814_ThreePhase_PhaseLossCallback);
+    pc814_threephase_enable_events(&threephase_system);
+}
+
+/* ========== Capture Interrupt Dispatch ========== */
+/*
+ * One registry maps (timer, channel) to the phase handles, so the capture
+ * callback needs no chain of instance comparisons however many channels
+ * are added.
+ */
+static pc814_dispatch_t capture_registry;
+
+/**
+ * Register the three phase channels (call after PC814_ThreePhase_Init)
+ */
+void PC814_ThreePhase_InitDispatch(void)
+{
+    pc814_dispatch_init(&capture_registry);
+    pc814_dispatch_register(&capture_registry, htim2.Instance, 0, &pc814_phase_a);
+    pc814_dispatch_register(&capture_registry, htim2.Instance, 1, &pc814_phase_b);
+    pc814_dispatch_register(&capture_registry, htim2.Instance, 2, &pc814_phase_c);
+}
+
+/**
+ * Single entry for every timer and channel (call from HAL_TIM_IC_CaptureCallback)
+ */
+void PC814_ThreePhase_DispatchCaptureCallback(TIM_HandleTypeDef *htim)
+{
+    uint8_t channel;
+    
+    switch (htim->Channel) {
+        case HAL_TIM_ACTIVE_CHANNEL_1:
+            channel = 0;
+            break;
+        case HAL_TIM_ACTIVE_CHANNEL_2:
+            channel = 1;
+            break;
+        case HAL_TIM_ACTIVE_CHANNEL_3:
+            channel = 2;
+            break;
+        case HAL_TIM_ACTIVE_CHANNEL_4:
+            channel = 3;
+            break;
+        default:
+            return;
+    }
+    
+    pc814_dispatch_capture(&capture_registry, htim->Instance, channel);
+}
+
+/* ========== Shared-Timebase Capture (one timer, three channels) ========== */
+/*
+ * Phases A/B/C on TIM3 channels 1/2/3 (16-bit timer extended to 32 bits).
+ * All three handles share one port; captures are passed in by the ISR, so
+ * inter-phase angles come from raw ticks at full timer resolution.
+ */
+extern TIM_HandleTypeDef htim3;
+extern pc814_port_t pc814_port_shared;  /* timer_get_frequency = TIM3 clock */
+
+static pc814_timebase_t shared_timebase;
+
+/**
+ * Initialize three-phase system on one multi-channel timer
+ */
+void PC814_ThreePhase_InitSharedTimer(void)
+{
+    pc814_init(&pc814_phase_a, &pc814_port_shared, PC814_PULL_UP, PC814_EDGE_RISING);
+    pc814_init(&pc814_phase_b, &pc814_port_shared, PC814_PULL_UP, PC814_EDGE_RISING);
+    pc814_init(&pc814_phase_c, &pc814_port_shared, PC814_PULL_UP, PC814_EDGE_RISING);
+    
+    pc814_threephase_init(&threephase_system, &pc814_phase_a, &pc814_phase_b, &pc814_phase_c);
+    
+    pc814_timebase_init(&shared_timebase, 16);
+    pc814_threephase_set_shared_timebase(&threephase_system, &shared_timebase);
+    
+    HAL_TIM_Base_Start_IT(&htim3);
+    HAL_TIM_IC_Start_IT(&htim3, TIM_CHANNEL_1);
+    HAL_TIM_IC_Start_IT(&htim3, TIM_CHANNEL_2);
+    HAL_TIM_IC_Start_IT(&htim3, TIM_CHANNEL_3);
+}
+
+/**
+ * Single ISR for all three channels (call from HAL_TIM_IC_CaptureCallback)
+ */
+void PC814_ThreePhase_SharedCaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance != htim3.Instance) {
+        return;
+    }
+    
+    bool overflow_pending = (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE) != RESET);
+    
+    switch (htim->Channel) {
+        case HAL_TIM_ACTIVE_CHANNEL_1:
+            pc814_threephase_capture(&threephase_system, PC814_PHASE_A,
+                                     HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_1), overflow_pending);
+            break;
+        case HAL_TIM_ACTIVE_CHANNEL_2:
+            pc814_threephase_capture(&threephase_system, PC814_PHASE_B,
+                                     HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_2), overflow_pending);
+            break;
+        case HAL_TIM_ACTIVE_CHANNEL_3:
+            pc814_threephase_capture(&threephase_system, PC814_PHASE_C,
+                                     HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_3), overflow_pending);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Timer overflow (call from HAL_TIM_PeriodElapsedCallback)
+ */
+void PC814_ThreePhase_SharedOverflowCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == htim3.Instance) {
+        pc814_timebase_overflow(&shared_timebase);
+    }
+}
+
 /* ========== Main Usage Example ========== */
 /*
 void main(void)
@@ -0,0 +1,198 @@
+/*
+ * PC814_Window.c
+ * 
+ * PC814 Rolling Frequency Windows Implementation
+ * Min/max/mean/standard deviation of line frequency over 1 s, 1 min and 15 min
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Cascaded aggregate buckets, integer update per cycle
+ */
+
+#include "PC814_Window.h"
+#include <string.h>
+#include <math.h>
+
+/* Lower-level buckets merged into one bucket of each level (level 0 is timed) */
+static const uint8_t level_merge[PC814_WINDOW_COUNT] = {
+    1, PC814_WINDOW_1MIN_MERGE, PC814_WINDOW_15MIN_MERGE
+};
+
+/* Merge aggregate 'src' into 'dst' */
+static void bucket_merge(pc814_window_bucket_t *dst, const pc814_window_bucket_t *src)
+{
+    if (src->count == 0) {
+        return;
+    }
+    
+    if (dst->count == 0 || src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (dst->count == 0 || src->max > dst->max) {
+        dst->max = src->max;
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    dst->sumsq += src->sumsq;
+}
+
+/* Close the current bucket of a level and cascade into the next level */
+static void level_close(pc814_windows_t *windows, uint8_t index)
+{
+    pc814_window_level_t *level = &windows->level[index];
+    
+    level->ring[level->head] = level->current;
+    level->head = (uint8_t)((level->head + 1) % level->size);
+    if (level->filled < level->size) {
+        level->filled++;
+    }
+    
+    /* Rebuild the window from the ring (once per bucket, not per cycle) */
+    memset(&level->window, 0, sizeof(pc814_window_bucket_t));
+    for (uint8_t i = 0; i < level->filled; i++) {
+        bucket_merge(&level->window, &level->ring[i]);
+    }
+    
+    if (index + 1 < PC814_WINDOW_COUNT) {
+        pc814_window_level_t *next = &windows->level[index + 1];
+        
+        bucket_merge(&next->current, &level->current);
+        if (++next->merged >= level_merge[index + 1]) {
+            level_close(windows, (uint8_t)(index + 1));
+        }
+    }
+    
+    level->merged = 0;
+    memset(&level->current, 0, sizeof(pc814_window_bucket_t));
+}
+
+/* Bus listener: valid zero-crossings of the source handle */
+static void windows_listener(void *context, pc814_handle_t *handle,
+                             pc814_bus_event_t event, const pc814_data_t *data)
+{
+    pc814_windows_t *windows = (pc814_windows_t *)context;
+    
+    (void)event;
+    if (handle == windows->handle && !data->synthetic) {
+        pc814_windows_add(windows, data->period_us, data->timestamp_us);
+    }
+}
+
+/* Clear buckets and rings */
+static void windows_clear(pc814_windows_t *windows)
+{
+    memset(windows->level, 0, sizeof(windows->level));
+    memset(windows->ring_1s, 0, sizeof(windows->ring_1s));
+    memset(windows->ring_1min, 0, sizeof(windows->ring_1min));
+    memset(windows->ring_15min, 0, sizeof(windows->ring_15min));
+    
+    windows->level[PC814_WINDOW_1S].ring = windows->ring_1s;
+    windows->level[PC814_WINDOW_1S].size = PC814_WINDOW_1S_BUCKETS;
+    windows->level[PC814_WINDOW_1MIN].ring = windows->ring_1min;
+    windows->level[PC814_WINDOW_1MIN].size = PC814_WINDOW_1MIN_BUCKETS;
+    windows->level[PC814_WINDOW_15MIN].ring = windows->ring_15min;
+    windows->level[PC814_WINDOW_15MIN].size = PC814_WINDOW_15MIN_BUCKETS;
+    windows->started = false;
+}
+
+/* Initialize rolling windows */
+pc814_status_t pc814_windows_init(pc814_windows_t *windows, pc814_handle_t *handle)
+{
+    if (windows == NULL || handle == NULL) {
+        return PC814_ERROR;
+    }
+    
+    memset(windows, 0, sizeof(pc814_windows_t));
+    windows->handle = handle;
+    windows->reference_mhz = (int32_t)(handle->expected_frequency * 1000UL);
+    windows_clear(windows);
+    windows->initialized = true;
+    
+    return PC814_OK;
+}
+
+/* Feed windows from an event bus */
+pc814_status_t pc814_windows_attach(pc814_windows_t *windows, pc814_bus_t *bus)
+{
+    if (windows == NULL || !windows->initialized) {
+        return PC814_ERROR;
+    }
+    
+    return pc814_bus_subscribe(bus, PC814_BUS_MASK(PC814_BUS_VALID_ZC), 1,
+                               windows_listener, windows, NULL);
+}
+
+/* Add one period */
+void pc814_windows_add(pc814_windows_t *windows, uint32_t period_us, uint32_t timestamp_us)
+{
+    if (windows == NULL || !windows->initialized || period_us == 0) {
+        return;
+    }
+    
+    if (!windows->started) {
+        windows->bucket_start_us = timestamp_us;
+        windows->started = true;
+    } else if (timestamp_us - windows->bucket_start_us >= PC814_WINDOW_BUCKET_US) {
+        /* One close per sample; a longer gap restarts the bucket at this sample */
+        level_close(windows, PC814_WINDOW_1S);
+        if (timestamp_us - windows->bucket_start_us >= 2UL * PC814_WINDOW_BUCKET_US) {
+            windows->bucket_start_us = timestamp_us;
+        } else {
+            windows->bucket_start_us += PC814_WINDOW_BUCKET_US;
+        }
+    }
+    
+    pc814_window_bucket_t *bucket = &windows->level[PC814_WINDOW_1S].current;
+    int32_t dev = (int32_t)(1000000000UL / period_us) - windows->reference_mhz;
+    
+    if (bucket->count == 0 || dev < bucket->min) {
+        bucket->min = dev;
+    }
+    if (bucket->count == 0 || dev > bucket->max) {
+        bucket->max = dev;
+    }
+    bucket->count++;
+    bucket->sum += dev;
+    bucket->sumsq += (uint64_t)((int64_t)dev * dev);
+}
+
+/* Get statistics of one window */
+pc814_status_t pc814_windows_get(pc814_windows_t *windows, pc814_window_id_t window,
+                                 pc814_window_stats_t *stats)
+{
+    if (windows == NULL || stats == NULL || !windows->initialized ||
+        (uint32_t)window >= PC814_WINDOW_COUNT) {
+        return PC814_ERROR;
+    }
+    
+    const pc814_window_level_t *level = &windows->level[window];
+    pc814_window_bucket_t agg = level->window;
+    
+    memset(stats, 0, sizeof(pc814_window_stats_t));
+    if (agg.count == 0) {
+        return PC814_ERROR;
+    }
+    
+    float n = (float)agg.count;
+    float mean = (float)agg.sum / n;
+    float var = (float)agg.sumsq / n - mean * mean;
+    float ref = (float)windows->reference_mhz;
+    
+    stats->min_hz = (ref + (float)agg.min) / 1000.0f;
+    stats->max_hz = (ref + (float)agg.max) / 1000.0f;
+    stats->mean_hz = (ref + mean) / 1000.0f;
+    stats->stddev_hz = (var > 0.0f) ? sqrtf(var) / 1000.0f : 0.0f;
+    stats->samples = agg.count;
+    stats->complete = (level->filled == level->size);
+    
+    return PC814_OK;
+}
+
+/* Clear all windows */
+void pc814_windows_reset(pc814_windows_t *windows)
+{
+    if (windows != NULL && windows->initialized) {
+        windows_clear(windows);
+    }
+}
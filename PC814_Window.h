@@ -0,0 +1,142 @@
+/*
+ * PC814_Window.h
+ * 
+ * PC814 Rolling Frequency Windows
+ * Min/max/mean/standard deviation of line frequency over 1 s, 1 min and 15 min
+ * 
+ * Author: Ehsan Zehni
+ * Created: 2025
+ * 
+ * Description: Cascaded rings of aggregate buckets. Each valid zero-crossing
+ *              is added to the current 100 ms bucket; a closed bucket is
+ *              merged into the next level's bucket (5 s, then 1 min), so no
+ *              period is stored. Every window is the merge of its ring and
+ *              is rebuilt only when a bucket closes, so the per-cycle cost is
+ *              constant and the worst case (all three levels closing on the
+ *              same cycle) is bounded by the ring sizes.
+ *              Samples are frequency deviations from the expected frequency
+ *              in mHz with integer sums; floats are used only when reading.
+ */
+
+#ifndef PC814_WINDOW_H
+#define PC814_WINDOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "PC814.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Ring layout: 1 s = 10 x 100 ms, 1 min = 12 x 5 s, 15 min = 15 x 1 min */
+#define PC814_WINDOW_BUCKET_US        100000UL  /* Span of a 1 s window bucket */
+#define PC814_WINDOW_1S_BUCKETS       10
+#define PC814_WINDOW_1MIN_BUCKETS     12
+#define PC814_WINDOW_1MIN_MERGE       50        /* 100 ms buckets per 5 s bucket */
+#define PC814_WINDOW_15MIN_BUCKETS    15
+#define PC814_WINDOW_15MIN_MERGE      12        /* 5 s buckets per 1 min bucket */
+
+/* Window horizons */
+typedef enum {
+    PC814_WINDOW_1S = 0,
+    PC814_WINDOW_1MIN = 1,
+    PC814_WINDOW_15MIN = 2,
+    PC814_WINDOW_COUNT = 3
+} pc814_window_id_t;
+
+/* Frequency statistics of one window */
+typedef struct {
+    float min_hz;                /* Minimum frequency */
+    float max_hz;                /* Maximum frequency */
+    float mean_hz;               /* Mean of per-cycle frequencies */
+    float stddev_hz;             /* Standard deviation of per-cycle frequencies */
+    uint32_t samples;            /* Zero-crossings in the window */
+    bool complete;               /* Ring full: the window spans the whole horizon */
+} pc814_window_stats_t;
+
+/* Aggregate of a span of samples (deviation from reference, mHz) */
+typedef struct {
+    uint32_t count;              /* Samples */
+    int32_t min;                 /* Minimum deviation */
+    int32_t max;                 /* Maximum deviation */
+    int64_t sum;                 /* Sum of deviations */
+    uint64_t sumsq;              /* Sum of squared deviations */
+} pc814_window_bucket_t;
+
+/* One level of the cascade */
+typedef struct {
+    pc814_window_bucket_t *ring; /* Closed buckets */
+    uint8_t size;                /* Ring size */
+    uint8_t head;                /* Next ring slot to write */
+    uint8_t filled;              /* Closed buckets in the ring */
+    uint8_t merged;              /* Lower-level buckets merged into 'current' */
+    pc814_window_bucket_t current; /* Bucket being filled */
+    pc814_window_bucket_t window;  /* Merge of the ring (the window result) */
+} pc814_window_level_t;
+
+/* Rolling windows of one handle */
+typedef struct {
+    pc814_handle_t *handle;      /* Source handle */
+    int32_t reference_mhz;       /* Expected frequency at init (mHz) */
+    uint32_t bucket_start_us;    /* Start of the current 100 ms bucket */
+    bool started;                /* First sample seen */
+    pc814_window_level_t level[PC814_WINDOW_COUNT];
+    pc814_window_bucket_t ring_1s[PC814_WINDOW_1S_BUCKETS];
+    pc814_window_bucket_t ring_1min[PC814_WINDOW_1MIN_BUCKETS];
+    pc814_window_bucket_t ring_15min[PC814_WINDOW_15MIN_BUCKETS];
+    bool initialized;            /* Initialization flag */
+} pc814_windows_t;
+
+/**
+ * Initialize rolling windows for a handle
+ * Set the handle's expected frequency first; it is the reference the
+ * deviations are summed against.
+ * @param windows Pointer to windows structure
+ * @param handle Source handle
+ * @return PC814_OK on success
+ */
+pc814_status_t pc814_windows_init(pc814_windows_t *windows, pc814_handle_t *handle);
+
+/**
+ * Feed the windows from an event bus (valid, non-synthetic zero-crossings)
+ * Subscribes to the bus: attach before pc814_start or with the capture
+ * interrupt disabled (see pc814_bus_subscribe).
+ * @param windows Pointer to windows structure
+ * @param bus Event bus attached to the source handle
+ * @return PC814_OK on success, PC814_ERROR if the bus is full
+ */
+pc814_status_t pc814_windows_attach(pc814_windows_t *windows, pc814_bus_t *bus);
+
+/**
+ * Add one period (when not fed from a bus)
+ * Gaps without samples are skipped: a window covers the last buckets that
+ * received data.
+ * @param windows Pointer to windows structure
+ * @param period_us Period in microseconds
+ * @param timestamp_us Zero-crossing time in microseconds
+ */
+void pc814_windows_add(pc814_windows_t *windows, uint32_t period_us, uint32_t timestamp_us);
+
+/**
+ * Get statistics of one window
+ * @param windows Pointer to windows structure
+ * @param window Window horizon
+ * @param stats Pointer to statistics structure to fill
+ * @return PC814_OK on success, PC814_ERROR if no bucket of the window has closed yet
+ */
+pc814_status_t pc814_windows_get(pc814_windows_t *windows, pc814_window_id_t window,
+                                 pc814_window_stats_t *stats);
+
+/**
+ * Clear all windows
+ * @param windows Pointer to windows structure
+ */
+void pc814_windows_reset(pc814_windows_t *windows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC814_WINDOW_H */
+